@@ -0,0 +1,68 @@
+// -------------------------------------------------------------------------------------------
+// Basic Master Transfer
+// -------------------------------------------------------------------------------------------
+//
+// This creates a simple I2C Master device which periodically reads a block of registers from
+// a Slave device using a combined transaction.  The register address write and the data read
+// are given to transfer() as a message list, which sends them as one bus transaction joined
+// by a repeated START (same as Linux I2C_RDWR).
+//
+// The target is set for a typical register-based sensor at address 0x68, reading 6 bytes
+// starting at register 0x3B.  Change these to suit the attached device.
+//
+// This example code is in the public domain.
+//
+// -------------------------------------------------------------------------------------------
+
+#include <i2c_t3.h>
+
+// Target
+#define TARGET 0x68
+#define REG    0x3B
+
+// Memory
+uint8_t reg;
+uint8_t databuf[6];
+i2cTransaction msgs[2] = {};
+
+void setup()
+{
+    pinMode(LED_BUILTIN,OUTPUT);    // LED
+    digitalWrite(LED_BUILTIN,LOW);  // LED off
+
+    // Setup for Master mode, pins 18/19, external pullups, 400kHz, 200ms default timeout
+    Wire.begin(I2C_MASTER, 0x00, I2C_PINS_18_19, I2C_PULLUP_EXT, 400000);
+    Wire.setDefaultTimeout(200000); // 200ms
+
+    // Message list - write register address, then read data
+    msgs[0].addr = TARGET;
+    msgs[0].rw   = I2C_WRITE;
+    msgs[0].data = &reg;
+    msgs[0].len  = 1;
+    msgs[1].addr = TARGET;
+    msgs[1].rw   = I2C_READ;
+    msgs[1].data = databuf;
+    msgs[1].len  = sizeof(databuf);
+
+    Serial.begin(115200);
+}
+
+void loop()
+{
+    digitalWrite(LED_BUILTIN,HIGH);   // LED on
+
+    // Read registers
+    reg = REG;
+    if(Wire.transfer(msgs, 2) == 2)
+    {
+        Serial.print("Data:");
+        for(size_t idx=0; idx < msgs[1].count; idx++)
+            Serial.printf(" %02X", databuf[idx]);
+        Serial.print("\n");
+    }
+    else
+        Serial.printf("FAIL (status %d/%d)\n", msgs[0].status, msgs[1].status);
+
+    digitalWrite(LED_BUILTIN,LOW);    // LED off
+    delay(500);                       // Delay to space out reads
+}
@@ -0,0 +1,68 @@
+// -------------------------------------------------------------------------------------------
+// Basic Periodic Job
+// -------------------------------------------------------------------------------------------
+//
+// This creates a simple I2C Master device which samples a block of registers from a Slave
+// device at a fixed 1kHz rate.  The sampling is run entirely in interrupt context (timer
+// interrupt queues the transfer, I2C ISR runs it), so sample timing does not depend on what
+// loop() is doing.  The latest complete sample can be read at any time.
+//
+// The target is set for a typical register-based sensor at address 0x68, reading 6 bytes
+// starting at register 0x3B.  Change these to suit the attached device.
+//
+// This example code is in the public domain.
+//
+// -------------------------------------------------------------------------------------------
+
+#include <i2c_t3.h>
+
+// Target
+#define TARGET 0x68
+#define REG    0x3B
+#define LEN    6
+
+// Memory
+const uint8_t reg = REG;
+uint8_t jobbuf[2*LEN];  // double buffer
+uint8_t databuf[LEN];
+i2cJob job = {};
+
+void setup()
+{
+    pinMode(LED_BUILTIN,OUTPUT);    // LED
+    digitalWrite(LED_BUILTIN,LOW);  // LED off
+
+    // Setup for Master mode, pins 18/19, external pullups, 400kHz
+    Wire.begin(I2C_MASTER, 0x00, I2C_PINS_18_19, I2C_PULLUP_EXT, 400000);
+
+    Serial.begin(115200);
+
+    // Setup job - write register address, then read data, every 1ms
+    job.addr   = TARGET;
+    job.txData = &reg;
+    job.txLen  = 1;
+    job.rxBuf  = jobbuf;
+    job.rxLen  = LEN;
+    job.period = 1000;
+    Wire.addJob(job);
+}
+
+void loop()
+{
+    uint32_t seq;
+
+    // Print latest sample - loop timing does not affect sampling
+    seq = Wire.readJob(job, databuf);
+    if(seq)
+    {
+        Serial.printf("Sample %lu:", seq);
+        for(size_t idx=0; idx < LEN; idx++)
+            Serial.printf(" %02X", databuf[idx]);
+        Serial.printf(" (status %d, overruns %lu)\n", job.status, job.overruns);
+    }
+    else
+        Serial.print("No sample\n");
+
+    digitalWrite(LED_BUILTIN,!digitalRead(LED_BUILTIN)); // LED toggle
+    delay(250);
+}
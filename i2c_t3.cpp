@@ -29,34 +29,59 @@
     defined(__MK64FX512__) || defined(__MK66FX1M0__) // 3.0/3.1-3.2/LC/3.5/3.6
 
 #include "i2c_t3.h"
+#include <new> // placement new, static DMA storage
 
 
 // ------------------------------------------------------------------------------------------------------
 // Static inits
 //
-#define I2C_STRUCT(a1,f,c1,s,d,c2,flt,ra,smb,a2,slth,sltl,scl,sda) \
-    {a1, f, c1, s, d, c2, flt, ra, smb, a2, slth, sltl, {}, 0, 0, {}, 0, 0, I2C_OP_MODE_ISR, I2C_MASTER, scl, sda, I2C_PULLUP_EXT, 100000, \
-     I2C_STOP, I2C_WAITING, 0, 0, 0, 0, I2C_DMA_OFF, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0, {}, 0, 0 }
+#define I2C_STRUCT(a1,f,c1,s,d,c2,flt,ra,smb,a2,slth,sltl,scl,sda,buf) \
+    {a1, f, c1, s, d, c2, flt, ra, smb, a2, slth, sltl, buf.rx, sizeof(buf.rx), buf.tx, sizeof(buf.tx), scl, sda}
+
+static i2cBuffers<I2C0_TX_BUFFER_LENGTH, I2C0_RX_BUFFER_LENGTH> i2c0Buffers;
+#if I2C_BUS_NUM >= 2
+    static i2cBuffers<I2C1_TX_BUFFER_LENGTH, I2C1_RX_BUFFER_LENGTH> i2c1Buffers;
+#endif
+#if I2C_BUS_NUM >= 3
+    static i2cBuffers<I2C2_TX_BUFFER_LENGTH, I2C2_RX_BUFFER_LENGTH> i2c2Buffers;
+#endif
+#if I2C_BUS_NUM >= 4
+    static i2cBuffers<I2C3_TX_BUFFER_LENGTH, I2C3_RX_BUFFER_LENGTH> i2c3Buffers;
+#endif
 
 struct i2cStruct i2c_t3::i2cData[] =
 {
-    I2C_STRUCT(&I2C0_A1, &I2C0_F, &I2C0_C1, &I2C0_S, &I2C0_D, &I2C0_C2, &I2C0_FLT, &I2C0_RA, &I2C0_SMB, &I2C0_A2, &I2C0_SLTH, &I2C0_SLTL, 19, 18)
+    I2C_STRUCT(&I2C0_A1, &I2C0_F, &I2C0_C1, &I2C0_S, &I2C0_D, &I2C0_C2, &I2C0_FLT, &I2C0_RA, &I2C0_SMB, &I2C0_A2, &I2C0_SLTH, &I2C0_SLTL, 19, 18, i2c0Buffers)
 #if (I2C_BUS_NUM >= 2) && defined(__MK20DX256__) // 3.1/3.2
-   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 29, 30)
+   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 29, 30, i2c1Buffers)
 #elif (I2C_BUS_NUM >= 2) && defined(__MKL26Z64__) // LC
-   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 22, 23)
+   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 22, 23, i2c1Buffers)
 #elif (I2C_BUS_NUM >= 2) && (defined(__MK64FX512__) || defined(__MK66FX1M0__))  // 3.5/3.6
-   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 37, 38)
+   ,I2C_STRUCT(&I2C1_A1, &I2C1_F, &I2C1_C1, &I2C1_S, &I2C1_D, &I2C1_C2, &I2C1_FLT, &I2C1_RA, &I2C1_SMB, &I2C1_A2, &I2C1_SLTH, &I2C1_SLTL, 37, 38, i2c1Buffers)
 #endif
 #if (I2C_BUS_NUM >= 3) && (defined(__MK64FX512__) || defined(__MK66FX1M0__))  // 3.5/3.6
-   ,I2C_STRUCT(&I2C2_A1, &I2C2_F, &I2C2_C1, &I2C2_S, &I2C2_D, &I2C2_C2, &I2C2_FLT, &I2C2_RA, &I2C2_SMB, &I2C2_A2, &I2C2_SLTH, &I2C2_SLTL, 3, 4)
+   ,I2C_STRUCT(&I2C2_A1, &I2C2_F, &I2C2_C1, &I2C2_S, &I2C2_D, &I2C2_C2, &I2C2_FLT, &I2C2_RA, &I2C2_SMB, &I2C2_A2, &I2C2_SLTH, &I2C2_SLTL, 3, 4, i2c2Buffers)
 #endif
 #if (I2C_BUS_NUM >= 4) && defined(__MK66FX1M0__) // 3.6
-   ,I2C_STRUCT(&I2C3_A1, &I2C3_F, &I2C3_C1, &I2C3_S, &I2C3_D, &I2C3_C2, &I2C3_FLT, &I2C3_RA, &I2C3_SMB, &I2C3_A2, &I2C3_SLTH, &I2C3_SLTL, 57, 56)
+   ,I2C_STRUCT(&I2C3_A1, &I2C3_F, &I2C3_C1, &I2C3_S, &I2C3_D, &I2C3_C2, &I2C3_FLT, &I2C3_RA, &I2C3_SMB, &I2C3_A2, &I2C3_SLTH, &I2C3_SLTL, 57, 56, i2c3Buffers)
 #endif
 };
 
 volatile uint8_t i2c_t3::isrActive = 0;
+struct i2cJob* volatile i2c_t3::jobList = nullptr;
+uint32_t i2c_t3::jobTickPeriod = 0;
+IntervalTimer i2c_t3::jobTimer;
+volatile uint8_t i2c_t3::retryTimerOn = 0;
+IntervalTimer i2c_t3::retryTimer;
+DMAChannel* i2c_t3::dmaPool[I2C_DMA_POOL] = {};
+alignas(DMAChannel) static uint8_t dmaPoolStore[I2C_DMA_POOL][sizeof(DMAChannel)]; // DMA pool channel storage
+#if defined(__MK64FX512__) || defined(__MK66FX1M0__) // 3.5/3.6
+    alignas(DMASetting) static uint8_t chainStore[I2C_BUS_NUM][I2C_DMA_CHAIN_TCDS][sizeof(DMASetting)]; // Chained DMA descriptor storage
+#endif
+#if defined(__cpp_impl_coroutine)
+    struct i2cAwait* volatile i2c_t3::awaitHead = nullptr;
+    struct i2cAwait* volatile i2c_t3::awaitTail = nullptr;
+#endif
 
 
 // ------------------------------------------------------------------------------------------------------
@@ -69,9 +94,13 @@ i2c_t3::i2c_t3(uint8_t i2c_bus)
 }
 i2c_t3::~i2c_t3()
 {
-    // if DMA active, delete DMA object
+    // if DMA active, release DMA pool if no other bus uses it
     if(i2c->opMode == I2C_OP_MODE_DMA)
-        delete i2c->DMA;
+    {
+        i2c->opMode = I2C_OP_MODE_ISR;
+        dmaReturn_(i2c);
+        dmaPoolFree_();
+    }
 }
 
 
@@ -192,7 +221,7 @@ uint8_t i2c_t3::validPin_(uint8_t bus, uint8_t pin, uint8_t offset)
 // Set Operating Mode - this configures operating mode of the I2C as either Immediate, ISR, or DMA.
 //                      By default Arduino-style begin() calls will initialize to ISR mode.  This can
 //                      only be called when the bus is idle (no changing mode in the middle of Tx/Rx).
-//                      Note that Slave mode can only use ISR operation.
+//                      Note that Slave mode can only use ISR or DMA (LC/3.5/3.6 Slave Rx only) operation.
 // return: 1=success, 0=fail (bus busy)
 // parameters:
 //      opMode = I2C_OP_MODE_ISR, I2C_OP_MODE_DMA, I2C_OP_MODE_IMM
@@ -200,12 +229,17 @@ uint8_t i2c_t3::validPin_(uint8_t bus, uint8_t pin, uint8_t offset)
 uint8_t i2c_t3::setOpMode_(struct i2cStruct* i2c, uint8_t bus, i2c_op_mode opMode)
 {
     if(*(i2c->S) & I2C_S_BUSY) return 0; // return immediately if bus busy
+    if(i2c->qHead != nullptr) return 0; // return immediately if transactions queued
 
     *(i2c->C1) = I2C_C1_IICEN; // reset I2C modes, stop intr, stop DMA
     *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear status flags just in case
 
-    // Slaves can only use ISR
-    if(i2c->currentMode == I2C_SLAVE) opMode = I2C_OP_MODE_ISR;
+    // Slaves can only use ISR, or DMA on LC/3.5/3.6 (needs STOP detect to end Slave Rx DMA)
+    #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+        if(i2c->currentMode == I2C_SLAVE && opMode == I2C_OP_MODE_IMM) opMode = I2C_OP_MODE_ISR;
+    #else
+        if(i2c->currentMode == I2C_SLAVE) opMode = I2C_OP_MODE_ISR;
+    #endif
 
     if(opMode == I2C_OP_MODE_IMM)
     {
@@ -242,68 +276,265 @@ uint8_t i2c_t3::setOpMode_(struct i2cStruct* i2c, uint8_t bus, i2c_op_mode opMod
         #endif
         if(opMode == I2C_OP_MODE_DMA)
         {
-            // attempt to get a DMA Channel (if not already allocated)
-            if(i2c->DMA == nullptr)
-                i2c->DMA = new DMAChannel();
+            // attempt to fill the shared DMA channel pool (if not already allocated), channels are
+            // borrowed per transfer
+            i2c->activeDMA = I2C_DMA_OFF;
+            i2c->opMode = I2C_OP_MODE_DMA;
+            if(!dmaPoolInit_())
+                i2c->opMode = I2C_OP_MODE_ISR; // revert to ISR mode if no DMA channels avail
+        }
+        else
+            i2c->opMode = I2C_OP_MODE_ISR;
+    }
+    dmaPoolFree_(); // release pool channels if no bus uses DMA mode
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// DMA Pool Init - allocates the DMA channels of the pool shared by all buses (if not already allocated),
+//                 intended for internal use only.  Channel objects are constructed in static storage, so the
+//                 heap is not used.  Channels which cannot be allocated are left empty.
+// return: number of pool channels available
+//
+uint8_t i2c_t3::dmaPoolInit_(void)
+{
+    uint8_t idx, count = 0;
+
+    for(idx=0; idx < I2C_DMA_POOL; idx++)
+    {
+        if(dmaPool[idx] == nullptr)
+        {
+            dmaPool[idx] = new (dmaPoolStore[idx]) DMAChannel();
             // check if object created but no available channel
-            if(i2c->DMA != nullptr && i2c->DMA->channel == DMA_NUM_CHANNELS)
+            if(dmaPool[idx]->channel == DMA_NUM_CHANNELS)
             {
-                // revert to ISR mode if no DMA channels avail
-                delete i2c->DMA;
-                i2c->DMA = nullptr;
-                i2c->opMode = I2C_OP_MODE_ISR;
+                dmaPool[idx]->~DMAChannel();
+                dmaPool[idx] = nullptr;
             }
-            else
+        }
+        if(dmaPool[idx] != nullptr) count++;
+    }
+    return count;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// DMA Pool Free - releases the DMA channels of the pool if no bus is in DMA mode, intended for internal use only
+// return: none
+//
+void i2c_t3::dmaPoolFree_(void)
+{
+    uint8_t idx;
+
+    for(idx=0; idx < I2C_BUS_NUM; idx++)
+        if(i2cData[idx].opMode == I2C_OP_MODE_DMA) return;
+    for(idx=0; idx < I2C_DMA_POOL; idx++)
+    {
+        if(dmaPool[idx] != nullptr) dmaPool[idx]->~DMAChannel(); // release channel, storage is static
+        dmaPool[idx] = nullptr;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// DMA Borrow - lends a pool DMA channel to a bus for one transfer, and routes the bus DMA request and DMA
+//              interrupt to it, intended for internal use only.  Buses sharing a DMAMUX source (on 3.6 I2C2
+//              shares with I2C1, and I2C3 shares with I2C0) cannot hold channels at the same time, as a request
+//              would trigger both channels.
+// return: 1=channel held, 0=none available (use ISR method)
+//
+uint8_t i2c_t3::dmaBorrow_(struct i2cStruct* i2c)
+{
+    static void (* const isr[])(void) = {i2c0_isr
+    #if I2C_BUS_NUM >= 2
+        ,i2c1_isr
+    #endif
+    #if I2C_BUS_NUM >= 3
+        ,i2c2_isr
+    #endif
+    #if I2C_BUS_NUM >= 4
+        ,i2c3_isr
+    #endif
+    };
+    static const uint8_t source[] = {DMAMUX_SOURCE_I2C0
+    #if I2C_BUS_NUM >= 2
+        ,DMAMUX_SOURCE_I2C1
+    #endif
+    #if I2C_BUS_NUM >= 3
+        ,DMAMUX_SOURCE_I2C2
+    #endif
+    #if I2C_BUS_NUM >= 4
+        ,DMAMUX_SOURCE_I2C3
+    #endif
+    };
+    uint8_t bus = i2c - i2cData, idx, b, used;
+    uint32_t primask;
+
+    if(i2c->DMA != nullptr) return 1; // already held
+
+    I2C_IRQ_SAVE(primask);
+    // check DMAMUX source conflict
+    for(b=0; b < I2C_BUS_NUM; b++)
+    {
+        if(b != bus && i2cData[b].DMA != nullptr && source[b] == source[bus])
+        {
+            I2C_IRQ_RESTORE(primask);
+            return 0;
+        }
+    }
+    // find free channel
+    for(idx=0; idx < I2C_DMA_POOL; idx++)
+    {
+        if(dmaPool[idx] == nullptr) continue;
+        for(b=0, used=0; b < I2C_BUS_NUM; b++)
+            if(i2cData[b].DMA == dmaPool[idx]) used = 1;
+        if(used) continue;
+        // setup static DMA settings
+        i2c->DMA = dmaPool[idx];
+        i2c->DMA->disableOnCompletion();
+        i2c->DMA->attachInterrupt(isr[bus]);
+        i2c->DMA->interruptAtCompletion();
+        i2c->DMA->triggerAtHardwareEvent(source[bus]);
+        I2C_IRQ_RESTORE(primask);
+        return 1;
+    }
+    I2C_IRQ_RESTORE(primask);
+    return 0;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// DMA Abort - aborts a timed out DMA transfer, intended for internal use only.  Stops the DMA channel and drops
+//             the I2C to idle (STOP if Master), then waits up to 2 bit periods for the bus to free.  If it does
+//             not (BUSY stuck, or a Slave holding SDA), the bus lines are clocked and the module is reset as in
+//             resetBus().  A Slave holding SCL low cannot be recovered, but the wait stays bounded.
+// return: none
+//
+void i2c_t3::dmaAbort_(struct i2cStruct* i2c, uint8_t bus)
+{
+    uint32_t primask;
+
+    I2C_IRQ_SAVE(primask);
+    if(i2c->activeDMA == I2C_DMA_OFF)
+    {
+        I2C_IRQ_RESTORE(primask); // transfer ended before abort
+        return;
+    }
+    i2c->DMA->disable();
+    i2c->DMA->clearError();
+    i2c->DMA->clearInterrupt();
+    i2c->DMA->clearComplete();
+    i2c->DMA->disableOnCompletion(); // restore static settings (chained frame replaces them)
+    i2c->DMA->interruptAtCompletion();
+    i2c->activeDMA = I2C_DMA_OFF;
+    *(i2c->C1) = I2C_C1_IICEN; // send STOP if Master, change to Rx mode, intr and DMA disabled
+    *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+    i2c->currentStatus = I2C_TIMEOUT;
+    I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
+    I2C_IRQ_RESTORE(primask);
+
+    // wait for bus to free, then recover if stuck
+    elapsedMicros deltaT;
+    while((*(i2c->S) & I2C_S_BUSY) && deltaT < i2c->stopWait);
+    if(*(i2c->S) & I2C_S_BUSY)
+    {
+        resetBus_(i2c, bus);
+        i2c->currentStatus = I2C_TIMEOUT;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// DMA Return - returns a borrowed DMA channel to the pool once the bus DMA is off, intended for internal use only
+// return: none
+//
+void i2c_t3::dmaReturn_(struct i2cStruct* i2c)
+{
+    uint32_t primask;
+
+    I2C_IRQ_SAVE(primask);
+    if(i2c->DMA != nullptr && i2c->activeDMA == I2C_DMA_OFF)
+    {
+        i2c->DMA->disable();
+        i2c->DMA->disableTrigger(); // free DMAMUX source for buses sharing it
+        i2c->DMA->clearComplete();
+        i2c->DMA = nullptr;
+    }
+    I2C_IRQ_RESTORE(primask);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Calibrate DMA - determines the DMA threshold at the current rate and clock settings.  Reads of increasing
+//                 length are done from the target using both ISR and DMA methods, and the CPU time left free
+//                 while each runs is measured (as foreground loop count).  The threshold is set to the
+//                 shortest length where DMA leaves at least as much CPU time free as ISR (or maxLen+1 if none).
+// return: new DMA threshold, 0=fail (not DMA Master mode, or read error - threshold unchanged)
+// parameters:
+//      addr = target 7bit slave address
+//      maxLen = max read length to try (limited to Rx buffer length)
+//
+uint16_t i2c_t3::calibrateDMA_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint16_t maxLen)
+{
+    if(i2c->opMode != I2C_OP_MODE_DMA || i2c->currentMode != I2C_MASTER) return 0;
+    if(maxLen > i2c->rxBufferSize) maxLen = i2c->rxBufferSize;
+
+    uint16_t prevThreshold = i2c->dmaThreshold, len;
+    uint32_t freeCount[2]; // [0]=ISR, [1]=DMA
+    for(len = 5; len <= maxLen; len++)
+    {
+        // allow 2 bit periods per bit plus overhead for each read
+        uint32_t timeout = (uint32_t)(len+1)*(18000000/i2c->currentRate) + 1000;
+        for(uint8_t dma = 0; dma < 2; dma++)
+        {
+            i2c->dmaThreshold = dma ? len : 0xFFFF;
+            freeCount[dma] = 0;
+            for(uint8_t rep = 0; rep < 2; rep++) // two reads per method to average out bus arrival jitter
             {
-                // DMA object has valid channel
-                if(bus == 0)
+                elapsedMicros deltaT;
+                sendRequest_(i2c, bus, addr, len, I2C_STOP, timeout);
+                while(!done_(i2c) && deltaT < timeout) freeCount[dma]++;
+                if(!finish_(i2c, bus, timeout))
                 {
-                    // setup static DMA settings
-                    i2c->DMA->disableOnCompletion();
-                    i2c->DMA->attachInterrupt(i2c0_isr);
-                    i2c->DMA->interruptAtCompletion();
-                    i2c->DMA->triggerAtHardwareEvent(DMAMUX_SOURCE_I2C0);
+                    i2c->dmaThreshold = prevThreshold;
+                    return 0;
                 }
-                #if I2C_BUS_NUM >= 2
-                    if(bus == 1)
-                    {
-                        // setup static DMA settings
-                        i2c->DMA->disableOnCompletion();
-                        i2c->DMA->attachInterrupt(i2c1_isr);
-                        i2c->DMA->interruptAtCompletion();
-                        i2c->DMA->triggerAtHardwareEvent(DMAMUX_SOURCE_I2C1);
-                    }
-                #endif
-                #if I2C_BUS_NUM >= 3
-                    // note: on T3.6 I2C2 shares DMAMUX with I2C1
-                    if(bus == 2)
-                    {
-                        // setup static DMA settings
-                        i2c->DMA->disableOnCompletion();
-                        i2c->DMA->attachInterrupt(i2c2_isr);
-                        i2c->DMA->interruptAtCompletion();
-                        i2c->DMA->triggerAtHardwareEvent(DMAMUX_SOURCE_I2C2);
-                    }
-                #endif
-                #if I2C_BUS_NUM >= 4
-                    // note: on T3.6 I2C3 shares DMAMUX with I2C0
-                    if(bus == 3)
-                    {
-                        // setup static DMA settings
-                        i2c->DMA->disableOnCompletion();
-                        i2c->DMA->attachInterrupt(i2c3_isr);
-                        i2c->DMA->interruptAtCompletion();
-                        i2c->DMA->triggerAtHardwareEvent(DMAMUX_SOURCE_I2C3);
-                    }
-                #endif
-                i2c->activeDMA = I2C_DMA_OFF;
-                i2c->opMode = I2C_OP_MODE_DMA;
             }
         }
-        else
-            i2c->opMode = I2C_OP_MODE_ISR;
+        if(freeCount[1] >= freeCount[0]) break;
     }
-    return 1;
+    i2c->dmaThreshold = len;
+    return len;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Set DMA Chain - enables chained DMA frames for DMA mode Master Tx (3.5/3.6 only).  Descriptors are
+//                 constructed in static storage on first enable.
+// return: 1=success, 0=fail (not 3.5/3.6, not DMA mode, or bus busy)
+// parameters:
+//      enable = 1=enable, 0=disable
+//
+uint8_t i2c_t3::setDMAChain_(struct i2cStruct* i2c, uint8_t bus, uint8_t enable)
+{
+    #if defined(__MK64FX512__) || defined(__MK66FX1M0__) // 3.5/3.6
+        if(*(i2c->S) & I2C_S_BUSY || i2c->activeDMA != I2C_DMA_OFF) return 0; // bus busy
+        if(enable)
+        {
+            if(i2c->opMode != I2C_OP_MODE_DMA) return 0;
+            if(i2c->chainTCD == nullptr)
+            {
+                for(uint8_t idx=0; idx < I2C_DMA_CHAIN_TCDS; idx++)
+                    new (chainStore[bus][idx]) DMASetting();
+                i2c->chainTCD = (DMASetting*)chainStore[bus];
+            }
+        }
+        i2c->dmaChain = enable;
+        return 1;
+    #else
+        return 0;
+    #endif
 }
 
 
@@ -354,6 +585,12 @@ void i2c_t3::setRate_(struct i2cStruct* i2c, uint32_t busFreq, uint32_t i2cFreq)
     // save current rate setting
     i2c->currentRate = busFreq/i2c_div_num[idx];
 
+    // rate dependent settle times: bus free time tBUF (~0.47 bit period, nearest usec), Master Rx settle before
+    // STOP (half bit period, limited to 1us), and max wait for a STOP to free the bus (2 bit periods)
+    i2c->busFreeTime = (470000 + i2c->currentRate/2) / i2c->currentRate;
+    i2c->stopSettle = (500000 / i2c->currentRate) ? 1 : 0;
+    i2c->stopWait = 2000000 / i2c->currentRate + 1;
+
     // Set filter
     if(busFreq >= 48000000)
         *(i2c->FLT) = 4;
@@ -435,8 +672,9 @@ uint8_t i2c_t3::pinConfigure_(struct i2cStruct* i2c, uint8_t bus, uint8_t pinSCL
 
 // ------------------------------------------------------------------------------------------------------
 // Acquire Bus - acquires bus in Master mode and escalates priority as needed, intended
-//               for internal use only
-// return: 1=success, 0=fail (cannot acquire bus)
+//               for internal use only.  In deferred acquire mode (ISR/DMA, LC/3.5/3.6) a busy bus is not
+//               polled, instead the caller loads the transfer and calls deferStart_().
+// return: 1=success, 2=deferred (bus busy, START not sent), 0=fail (cannot acquire bus)
 // parameters:
 //      timeout = timeout in microseconds
 //      forceImm = flag to indicate if immediate mode is required
@@ -450,15 +688,40 @@ uint8_t i2c_t3::acquireBus_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout
 
     // TODO may need to check bus busy before issuing START if multi-master
 
-    // start timer, then take control of the bus
+    // start timer, then wait for queued transactions to drain and the active transfer to complete (they own
+    // the bus until done, a START now would be a RepSTART in the middle of them).  This cannot wait if called
+    // from ISR, as queue is advanced by ISR.
     deltaT = 0;
+    if(!i2c_t3::isrActive)
+        while((i2c->qHead != nullptr || !done_(i2c)) && (timeout == 0 || deltaT < timeout)) wait_(i2c);
+    if(i2c->qHead != nullptr || !done_(i2c))
+    {
+        if(done_(i2c)) i2c->currentStatus = I2C_NOT_ACQ; // bus not acquired (status of an active transfer is kept)
+        I2C_ERR_INC(I2C_ERRCNT_NOT_ACQ);
+        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if cannot acquire bus
+        return 0;
+    }
+
+    // take control of the bus, new transfer so reset retry count
+    i2c->retryCount = 0;
     if(*(i2c->C1) & I2C_C1_MST)
     {
         // we are already the bus master, so send a repeated start
+        i2c->repStart = 1;
         *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_RSTA | I2C_C1_TX;
     }
     else
     {
+        i2c->repStart = 0;
+        #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+            if(i2c->acquireMode == I2C_ACQUIRE_DEFER && (*(i2c->S) & I2C_S_BUSY) &&
+               (i2c->opMode == I2C_OP_MODE_ISR || i2c->opMode == I2C_OP_MODE_DMA))
+            {
+                // defer START to STOP detect ISR, unless ISR cannot run (then poll)
+                checkPriority_(i2c, bus, forceImm);
+                if(!forceImm) return 2;
+            }
+        #endif
         while(timeout == 0 || deltaT < timeout)
         {
             // we are not currently the bus master, so check if bus ready
@@ -494,6 +757,21 @@ uint8_t i2c_t3::acquireBus_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout
         }
     }
 
+    checkPriority_(i2c, bus, forceImm);
+
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Check Priority - escalates I2C IRQ priority above calling routine as needed, intended for
+//                  internal use only
+// return: none
+// parameters:
+//      forceImm = flag set if current priority cannot be surpassed (immediate mode required)
+//
+void i2c_t3::checkPriority_(struct i2cStruct* i2c, uint8_t bus, uint8_t& forceImm)
+{
     #ifndef I2C_DISABLE_PRIORITY_CHECK
         // For ISR operation, check if current routine has higher priority than I2C IRQ, and if so
         // either escalate priority of I2C IRQ or send I2C using immediate mode.
@@ -543,8 +821,6 @@ uint8_t i2c_t3::acquireBus_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout
             }
         }
     #endif
-
-    return 1;
 }
 
 
@@ -629,15 +905,70 @@ uint8_t i2c_t3::endTransmission(struct i2cStruct* i2c, uint8_t bus, i2c_stop sen
 // parameters:
 //      i2c_stop = I2C_NOSTOP, I2C_STOP
 //      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
 //
-void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop sendStop, uint32_t timeout)
+void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop sendStop, uint32_t timeout,
+                               i2c_done_cb onDone, void* ctx)
 {
-    uint8_t status, forceImm=0;
-    size_t idx;
-
     // exit immediately if sending 0 bytes
     if(i2c->txBufferLength == 0) return;
 
+    // send from Tx buffer, first byte is target addr (segment is loaded once bus is acquired)
+    sendTx_(i2c, bus, i2c->txBuffer[0] >> 1, nullptr, 0, nullptr, sendStop, timeout, onDone, ctx);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Send Master Transmit Segments - non-blocking routine, starts scatter-gather transmit to slave at address.
+//                                 Data is sent directly from the list of segments, in order.  The segment
+//                                 list and its data must remain valid until the transmit is done.  Use
+//                                 done() or finish() to determine completion and status() to determine
+//                                 success/fail.
+// return: none
+// parameters:
+//      addr = target 7bit slave address
+//      segs = array of Tx segments
+//      n = number of segments
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const i2cSegment* segs, size_t n,
+                               i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone, void* ctx)
+{
+    static const struct i2cSegment empty = {nullptr, 0};
+
+    if(segs == nullptr) { segs = &empty; n = 1; } // no segments, address only
+    sendTx_(i2c, bus, addr, segs, n, nullptr, sendStop, timeout, onDone, ctx);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Send Tx - starts Master transmit of a list of segments, or of the Tx buffer, intended for internal use only.
+//           The Tx buffer segment is loaded only after the bus is acquired, as the Tx segment storage is used
+//           by queued transfers which may still own the bus.
+// return: none
+// parameters:
+//      addr = target 7bit slave address
+//      segs = array of Tx segments, nullptr = Tx buffer (after its target addr byte)
+//      n = number of segments
+//      bulk = bulk write descriptor (segs is then a single empty segment), nullptr = none
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendTx_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const i2cSegment* segs, size_t n,
+                     struct i2cBulk* bulk, i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone, void* ctx)
+{
+    uint8_t status, defer, data, forceImm=0;
+    size_t idx;
+
+    // send pending coalesced writes to this target first
+    flushWrites_(i2c, bus, addr);
+
     // update timeout
     timeout = (timeout == 0) ? i2c->defTimeout : timeout;
 
@@ -648,8 +979,34 @@ void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop send
     #endif
     *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
 
-    // try to take control of the bus
-    if(!acquireBus_(i2c, bus, timeout, forceImm)) return;
+    // try to take control of the bus, arm done callback (bus is now owned, so ISR will not call it early).  If
+    // another transfer still owns the bus its callback is kept, and this one fails directly.
+    status = acquireBus_(i2c, bus, timeout, forceImm);
+    if(!status && !done_(i2c))
+    {
+        if(onDone != nullptr) onDone(ctx, I2C_NOT_ACQ);
+        return;
+    }
+    i2c->doneCtx = ctx;
+    i2c->doneCb = onDone;
+    if(!status) return;
+    defer = (status == 2);
+
+    // load Tx segments (after bus acquired, as queued transfers use them), total length includes addr byte,
+    // a bulk write starts with an empty segment so the first byte refills it
+    if(segs == nullptr)
+    {
+        i2c->txSegBuf.data = &i2c->txBuffer[1];
+        i2c->txSegBuf.len = i2c->txBufferLength - 1;
+        segs = &i2c->txSegBuf;
+        n = 1;
+    }
+    i2c->bulk = bulk;
+    i2c->txSeg = segs;
+    i2c->txSegIndex = 0;
+    for(i2c->txLength = 1, idx = 0; idx < n; idx++)
+        i2c->txLength += segs[idx].len;
+    if(bulk != nullptr) i2c->txLength = bulk->len + 1;
 
     //
     // Immediate mode - blocking
@@ -660,10 +1017,12 @@ void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop send
         i2c->currentStatus = I2C_SENDING;
         i2c->currentStop = sendStop;
 
-        for(idx=0; idx < i2c->txBufferLength && (timeout == 0 || deltaT < timeout); idx++)
+        for(idx=0; idx < i2c->txLength && (timeout == 0 || deltaT < timeout); idx++)
         {
             // send data, wait for done
-            *(i2c->D) = i2c->txBuffer[idx];
+            data = (idx == 0) ? (uint8_t)(addr << 1) : txNext_(i2c);
+            if(i2c->currentStatus != I2C_SENDING) return; // bulk write underrun, aborted
+            *(i2c->D) = data;
 
             // wait for byte
             while(!(*(i2c->S) & I2C_S_IICIF) && (timeout == 0 || deltaT < timeout));
@@ -710,7 +1069,7 @@ void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop send
             *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX; // no STOP, stay in Tx mode, intr disabled
 
         // Set final status
-        if(idx < i2c->txBufferLength)
+        if(idx < i2c->txLength)
         {
             i2c->currentStatus = I2C_TIMEOUT; // Tx incomplete, mark as timeout
             I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
@@ -727,102 +1086,442 @@ void i2c_t3::sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop send
     //
     else if(i2c->opMode == I2C_OP_MODE_ISR || i2c->opMode == I2C_OP_MODE_DMA)
     {
-        // send target addr and enable interrupts
-        i2c->currentStatus = I2C_SENDING;
-        i2c->currentStop = sendStop;
-        i2c->txBufferIndex = 0;
-        if(i2c->opMode == I2C_OP_MODE_DMA && i2c->txBufferLength >= 5) // limit transfers less than 5 bytes to ISR method
-        {
-            // init DMA, let the hack begin
-            i2c->activeDMA = I2C_DMA_ADDR;
-            i2c->DMA->sourceBuffer(&i2c->txBuffer[2],i2c->txBufferLength-3); // DMA sends all except first/second/last bytes
-            i2c->DMA->destination(*(i2c->D));
-        }
-        // start ISR
-        *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX; // enable intr
-        *(i2c->D) = i2c->txBuffer[0]; // writing first data byte will start ISR
+        if(defer)
+            deferStart_(i2c, addr, sendStop, I2C_SENDING);
+        else
+            startTx_(i2c, (uint8_t)(addr << 1), sendStop);
     }
 }
 
 
 // ------------------------------------------------------------------------------------------------------
-// Master Receive - blocking routine with timeout, requests length bytes from slave at address. Receive data will
-//                  be placed in the Rx buffer. i2c_stop parameter can be used to indicate if command should end
-//                  with a STOP (I2C_STOP) or not (I2C_NOSTOP).
-// return: #bytes received = success, 0=fail (0 length request, NAK, timeout, or bus error)
+// Start Tx - starts ISR/DMA Master transmit on an acquired bus, intended for internal use only.  Payload
+//            is sent from the loaded Tx segments, and txLength is the total length including the address byte.
+// return: none
 // parameters:
-//      address = target 7bit slave address
-//      length = number of bytes requested
+//      addrByte = target address byte
 //      i2c_stop = I2C_NOSTOP, I2C_STOP
-//      timeout = timeout in microseconds
 //
-size_t i2c_t3::requestFrom_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout)
+void i2c_t3::startTx_(struct i2cStruct* i2c, uint8_t addrByte, i2c_stop sendStop)
 {
-    // exit immediately if request for 0 bytes
-    if(len == 0) return 0;
-
-    sendRequest_(i2c, bus, addr, len, sendStop, timeout);
-
-    // wait for completion or timeout
-    if(finish_(i2c, bus, timeout))
-        return i2c->rxBufferLength;
-    else
-        return 0; // NAK, timeout or bus error
+    // send target addr and enable interrupts, save target and first segment for retry
+    i2c->currentStatus = I2C_SENDING;
+    i2c->currentStop = sendStop;
+    i2c->txBufferIndex = 0;
+    i2c->curAddr = addrByte >> 1;
+    i2c->txSegFirst = i2c->txSeg;
+    if(i2c->opMode == I2C_OP_MODE_DMA && i2c->txLength >= i2c->dmaThreshold && dmaBorrow_(i2c)) // limit short transfers to ISR method
+    {
+        // init DMA, let the hack begin
+        i2c->activeDMA = I2C_DMA_ADDR;
+        i2c->txDmaLeft = i2c->txLength-3; // DMA sends all except first/second/last bytes
+        i2c->DMA->destination(*(i2c->D));
+    }
+    // start ISR
+    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX; // enable intr
+    *(i2c->D) = addrByte; // writing first data byte will start ISR
 }
 
 
 // ------------------------------------------------------------------------------------------------------
-// Start Master Receive - non-blocking routine, starts request for length bytes from slave at address. Receive
-//                        data will be placed in the Rx buffer. i2c_stop parameter can be used to indicate if
-//                        command should end with a STOP (I2C_STOP) or not (I2C_NOSTOP). Use done() or finish()
-//                        to determine completion and status() to determine success/fail.
+// Tx DMA Chunk - arms DMA with the next contiguous chunk of the Tx segments, intended for internal use only.
+//                A chunk ends at a segment boundary or at the end of the DMA portion of the transmit.  A bulk
+//                write underrun aborts the transfer (status is no longer I2C_SENDING).
 // return: none
-// parameters:
-//      address = target 7bit slave address
-//      length = number of bytes requested
-//      i2c_stop = I2C_NOSTOP, I2C_STOP
-//      timeout = timeout in microseconds (only used for Immediate operation)
 //
-void i2c_t3::sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout)
+void i2c_t3::txDmaChunk_(struct i2cStruct* i2c)
 {
-    uint8_t status, data, chkTimeout=0, forceImm=0;
+    size_t len;
 
-    // exit immediately if request for 0 bytes or request too large
-    if(len == 0) return;
-    if(len > I2C_RX_BUFFER_LENGTH) { i2c->currentStatus=I2C_BUF_OVF; return; }
+    while(i2c->txSegIndex >= i2c->txSeg->len) // skip finished segments, or refill bulk write
+    {
+        if(i2c->bulk == nullptr) i2c->txSeg++; else if(!txRefill_(i2c)) return; // underrun, aborted
+        i2c->txSegIndex = 0;
+    }
+    len = i2c->txSeg->len - i2c->txSegIndex;
+    if(len > i2c->txDmaLeft) len = i2c->txDmaLeft;
+    i2c->DMA->sourceBuffer(&i2c->txSeg->data[i2c->txSegIndex], len);
+    i2c->txSegIndex += len;
+    i2c->txDmaLeft -= len;
+}
 
-    i2c->reqCount = len; // store request length
-    i2c->rxBufferIndex = 0; // reset buffer
-    i2c->rxBufferLength = 0;
-    timeout = (timeout == 0) ? i2c->defTimeout : timeout;
 
-    // clear the status flags
-    #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
-        *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
-        *(i2c->FLT) &= ~I2C_FLT_SSIE;                   // disable STOP/START intr (not used in Master mode)
-    #endif
-    *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+// ------------------------------------------------------------------------------------------------------
+// Tx Refill - loads the next piece of a bulk write into the Tx segment storage, intended for internal use only.
+//             An underrun (refill returns 0 or no data) aborts the transfer with I2C_BUF_OVF and sends STOP.
+// return: 1=refilled, 0=underrun (transfer aborted, caller must not send)
+//
+uint8_t i2c_t3::txRefill_(struct i2cStruct* i2c)
+{
+    const uint8_t* data = nullptr;
+    size_t len;
 
-    // try to take control of the bus
-    if(!acquireBus_(i2c, bus, timeout, forceImm)) return;
+    len = i2c->bulk->refill(i2c->bulk->ctx, &data);
+    if(len != 0 && data != nullptr)
+    {
+        i2c->txSegBuf.data = data;
+        i2c->txSegBuf.len = len;
+        i2c->txSeg = &i2c->txSegBuf;
+        return 1;
+    }
 
-    //
-    // Immediate mode - blocking
-    //
-    if(i2c->opMode == I2C_OP_MODE_IMM || forceImm)
+    // underrun, abort transfer
+    if(i2c->activeDMA != I2C_DMA_OFF)
     {
-        elapsedMicros deltaT;
-        i2c->currentStatus = I2C_SEND_ADDR;
-        i2c->currentStop = sendStop;
+        i2c->DMA->disable();
+        i2c->DMA->clearInterrupt();
+        i2c->DMA->clearComplete();
+        i2c->activeDMA = I2C_DMA_OFF;
+    }
+    *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr and DMA disabled
+    *(i2c->S) = I2C_S_IICIF; // clear intr
+    i2c->currentStatus = I2C_BUF_OVF;
+    if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if underrun
+    return 0;
+}
 
-        // Send target address
-        *(i2c->D) = (addr << 1) | 1; // address + READ
 
-        // wait for byte
-        while(!(*(i2c->S) & I2C_S_IICIF) && (timeout == 0 || deltaT < timeout));
-        *(i2c->S) = I2C_S_IICIF;
-        if(timeout && deltaT >= timeout)
-        {
+// ------------------------------------------------------------------------------------------------------
+// Rx Drain - hands the received part of the bulk read chunk buffer to the drain callback, and restarts the
+//            chunk, intended for internal use only.
+// return: none
+//
+void i2c_t3::rxDrain_(struct i2cStruct* i2c)
+{
+    size_t len = i2c->rxCount - i2c->rxBase;
+
+    if(len && i2c->bulk->drain != nullptr) i2c->bulk->drain(i2c->bulk->ctx, i2c->rxPtr, len);
+    i2c->rxBase = i2c->rxCount;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Chain Load - loads linked DMA descriptors for the rest of a Master Tx frame after the first payload byte,
+//              intended for internal use only (3.5/3.6 only).  Each Tx segment gets a descriptor moving it to
+//              the data register, and the final descriptor writes C1 on the request following the last byte
+//              (STOP or hold bus, I2C and DMA disabled) and interrupts to end the frame.
+// return: 1=loaded, 0=not loaded (chaining disabled, or too many segments - use normal DMA)
+//
+uint8_t i2c_t3::chainLoad_(struct i2cStruct* i2c)
+{
+    #if defined(__MK64FX512__) || defined(__MK66FX1M0__) // 3.5/3.6
+        const struct i2cSegment* seg = i2c->txSeg;
+        size_t idx = i2c->txSegIndex, left = i2c->txLength - i2c->txBufferIndex - 1, len;
+        uint8_t n = 0, k;
+
+        if(!i2c->dmaChain || i2c->chainTCD == nullptr || i2c->bulk != nullptr) return 0; // bulk write refills as it goes
+
+        // payload descriptors, one per segment
+        while(left)
+        {
+            while(idx >= seg->len) { seg++; idx = 0; } // skip finished segments
+            if(n >= I2C_DMA_CHAIN_TCDS-1) return 0; // too many segments
+            len = seg->len - idx;
+            if(len > left) len = left;
+            i2c->chainTCD[n].TCD->CSR = 0;
+            i2c->chainTCD[n].sourceBuffer(&seg->data[idx], len);
+            i2c->chainTCD[n].destination(*(i2c->D));
+            idx += len;
+            left -= len;
+            n++;
+        }
+
+        // end of frame descriptor
+        i2c->chainC1 = (i2c->currentStop == I2C_STOP) ? I2C_C1_IICEN : (I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX);
+        i2c->chainTCD[n].TCD->CSR = 0;
+        i2c->chainTCD[n].source(i2c->chainC1);
+        i2c->chainTCD[n].destination(*(i2c->C1));
+        i2c->chainTCD[n].transferCount(1);
+        i2c->chainTCD[n].disableOnCompletion();
+        i2c->chainTCD[n].interruptAtCompletion();
+        for(k = 0; k < n; k++)
+            i2c->chainTCD[k].replaceSettingsOnCompletion(i2c->chainTCD[k+1]);
+
+        // load first descriptor into channel
+        i2c->DMA->clearComplete();
+        *(i2c->DMA) = i2c->chainTCD[0];
+        return 1;
+    #else
+        return 0;
+    #endif
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Chain Done - ends a chained DMA Master Tx frame on the DMA interrupt, intended for internal use only.  C1
+//              has already been written by the end of frame descriptor.
+// return: none
+// parameters:
+//      status = I2C status register
+//
+void i2c_t3::chainDone_(struct i2cStruct* i2c, uint8_t status)
+{
+    uint8_t err = i2c->DMA->error();
+
+    if(!err && !i2c->DMA->complete()) return; // not frame end (eg. STOP detect)
+
+    // restore static channel settings (end of frame descriptor left channel on C1)
+    i2c->DMA->disable();
+    i2c->DMA->clearError();
+    i2c->DMA->clearInterrupt();
+    i2c->DMA->clearComplete();
+    i2c->DMA->disableOnCompletion();
+    i2c->DMA->interruptAtCompletion();
+    i2c->activeDMA = I2C_DMA_OFF;
+    i2c->txBufferIndex = i2c->txLength;
+
+    if(err || (status & (I2C_S_ARBL | I2C_S_RXAK)))
+    {
+        if(status & I2C_S_ARBL)
+        {
+            i2c->currentStatus = I2C_ARB_LOST;
+            *(i2c->S) = I2C_S_ARBL; // clear arbl flag
+            I2C_ERR_INC(I2C_ERRCNT_ARBL);
+        }
+        else if(err)
+        {
+            i2c->currentStatus = I2C_DMA_ERR;
+            I2C_ERR_INC(I2C_ERRCNT_DMA_ERR);
+        }
+        else
+        {
+            i2c->currentStatus = I2C_DATA_NAK; // NAK detected at end of frame
+            I2C_ERR_INC(I2C_ERRCNT_DATA_NAK);
+        }
+        // note: error, so send STOP regardless of setting
+        *(i2c->C1) = I2C_C1_IICEN;
+        *(i2c->S) = I2C_S_IICIF; // clear intr
+        if(!retryCheck_(i2c, I2C_SENDING) && i2c->user_onError != nullptr)
+            i2c->user_onError(); // run Error callback (if not retrying)
+    }
+    else
+    {
+        // Tx complete, change to waiting state
+        i2c->currentStatus = I2C_WAITING;
+        *(i2c->S) = I2C_S_IICIF; // clear intr
+        if(i2c->user_onTransmitDone != nullptr) i2c->user_onTransmitDone();
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Rx DMA Stop - stops DMA mode Slave Rx and sets the received length, intended for internal use only.
+//                     Does nothing if Slave Rx DMA is not active.  C1 DMA enable must be cleared by caller.
+// return: none
+//
+void i2c_t3::slaveRxDmaStop_(struct i2cStruct* i2c)
+{
+    if(i2c->activeDMA != I2C_DMA_BULK) return;
+    i2c->DMA->disable();
+    if(i2c->DMA->complete())
+        i2c->rxBufferLength = i2c->rxBufferSize; // buffer full (destination wrapped to start)
+    else
+        i2c->rxBufferLength = (uint8_t*)i2c->DMA->destinationAddress() - i2c->rxBuffer;
+    i2c->DMA->clearComplete();
+    i2c->DMA->clearInterrupt();
+    i2c->activeDMA = I2C_DMA_OFF;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Rx Done - copies a completed Slave Rx message (Rx buffer, rxAddr, and receive time) into the next free
+//                 slot of the Slave Rx queue, intended for internal use only.  Does nothing if no queue is set,
+//                 and drops the message if the queue is full.  The slot is published (head advanced) only after
+//                 it is complete, so the application never sees a partial message.
+// return: none
+//
+void i2c_t3::slaveRxDone_(struct i2cStruct* i2c)
+{
+    struct i2cSlaveQueue* queue = i2c->slaveQueue;
+    struct i2cSlaveMsg* msg;
+    size_t slot;
+
+    if(queue == nullptr) return;
+    if(queue->head - queue->tail >= queue->depth) { queue->drops++; return; }
+    slot = queue->head % queue->depth;
+    msg = &queue->msgs[slot];
+    msg->rxAddr = i2c->rxAddr;
+    msg->len = (i2c->rxBufferLength < queue->size) ? i2c->rxBufferLength : queue->size;
+    msg->time = micros();
+    msg->data = &queue->buf[slot * queue->size];
+    memcpy(msg->data, i2c->rxBuffer, msg->len);
+    queue->head++;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Master Receive - blocking routine with timeout, requests length bytes from slave at address. Receive data will
+//                  be placed in the Rx buffer. i2c_stop parameter can be used to indicate if command should end
+//                  with a STOP (I2C_STOP) or not (I2C_NOSTOP).
+// return: #bytes received = success, 0=fail (0 length request, NAK, timeout, or bus error)
+// parameters:
+//      address = target 7bit slave address
+//      length = number of bytes requested
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds
+//
+size_t i2c_t3::requestFrom_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout)
+{
+    // exit immediately if request for 0 bytes
+    if(len == 0) return 0;
+
+    sendRequest_(i2c, bus, addr, len, sendStop, timeout);
+
+    // wait for completion or timeout
+    if(finish_(i2c, bus, timeout))
+        return i2c->rxBufferLength;
+    else
+        return 0; // NAK, timeout or bus error
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Master Receive Direct - blocking routine with timeout, requests length bytes from slave at address. Receive
+//                         data is placed directly in the caller buffer (Rx buffer is not used).
+// return: #bytes received = success, 0=fail (0 length request, NAK, timeout, or bus error)
+// parameters:
+//      address = target 7bit slave address
+//      buf = destination buffer, length bytes
+//      length = number of bytes requested
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds
+//
+size_t i2c_t3::requestFrom_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop, uint32_t timeout)
+{
+    // exit immediately if request for 0 bytes
+    if(len == 0) return 0;
+
+    sendRequest_(i2c, bus, addr, buf, len, sendStop, timeout);
+
+    // wait for completion or timeout
+    if(finish_(i2c, bus, timeout))
+        return i2c->rxCount;
+    else
+        return 0; // NAK, timeout or bus error
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Master Receive - non-blocking routine, starts request for length bytes from slave at address. Receive
+//                        data will be placed in the Rx buffer. i2c_stop parameter can be used to indicate if
+//                        command should end with a STOP (I2C_STOP) or not (I2C_NOSTOP). Use done() or finish()
+//                        to determine completion and status() to determine success/fail.
+// return: none
+// parameters:
+//      address = target 7bit slave address
+//      length = number of bytes requested
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout,
+                          i2c_done_cb onDone, void* ctx)
+{
+    // exit immediately if request for 0 bytes or request too large
+    if(len == 0) return;
+    if(len > i2c->rxBufferSize) { i2c->currentStatus=I2C_BUF_OVF; i2c->doneCtx=ctx; i2c->doneCb=onDone; return; }
+
+    // receive into Rx buffer
+    sendRequest_(i2c, bus, addr, i2c->rxBuffer, len, sendStop, timeout, onDone, ctx);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Master Receive Direct - non-blocking routine, starts request for length bytes from slave at address.
+//                               Receive data is placed directly in the caller buffer by the ISR or DMA, so no
+//                               copy out of the Rx buffer is needed.  The buffer must remain valid until done.
+//                               Use done() or finish() to determine completion and status() to determine
+//                               success/fail.
+// return: none
+// parameters:
+//      address = target 7bit slave address
+//      buf = destination buffer, length bytes
+//      length = number of bytes requested
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop, uint32_t timeout,
+                          i2c_done_cb onDone, void* ctx)
+{
+    sendRx_(i2c, bus, addr, buf, len, nullptr, sendStop, timeout, onDone, ctx);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Send Rx - starts Master receive into a caller buffer, or a bulk read, intended for internal use only
+// return: none
+// parameters:
+//      addr = target 7bit slave address
+//      buf = destination buffer (bulk read chunk buffer)
+//      len = number of bytes requested
+//      bulk = bulk read descriptor, nullptr = none
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendRx_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, struct i2cBulk* bulk,
+                     i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone, void* ctx)
+{
+    uint8_t status, defer, data, chkTimeout=0, forceImm=0;
+
+    // exit immediately if request for 0 bytes
+    if(len == 0) return;
+
+    // send pending coalesced writes to this target first
+    flushWrites_(i2c, bus, addr);
+
+    i2c->rxBufferIndex = 0; // reset buffer
+    i2c->rxBufferLength = 0;
+    timeout = (timeout == 0) ? i2c->defTimeout : timeout;
+
+    // clear the status flags
+    #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+        *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
+        *(i2c->FLT) &= ~I2C_FLT_SSIE;                   // disable STOP/START intr (not used in Master mode)
+    #endif
+    *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+
+    // try to take control of the bus, arm done callback (bus is now owned, so ISR will not call it early).  If
+    // another transfer still owns the bus its callback is kept, and this one fails directly.
+    status = acquireBus_(i2c, bus, timeout, forceImm);
+    if(!status && !done_(i2c))
+    {
+        if(onDone != nullptr) onDone(ctx, I2C_NOT_ACQ);
+        return;
+    }
+    i2c->doneCtx = ctx;
+    i2c->doneCb = onDone;
+    if(!status) return;
+    defer = (status == 2);
+
+    // load Rx destination (after bus acquired, as queued transfers use it)
+    i2c->bulk = bulk;
+    i2c->reqCount = len; // store request length
+    i2c->rxPtr = buf;
+    i2c->rxCount = 0;
+    i2c->rxBase = 0;
+
+    //
+    // Immediate mode - blocking
+    //
+    if(i2c->opMode == I2C_OP_MODE_IMM || forceImm)
+    {
+        elapsedMicros deltaT;
+        i2c->currentStatus = I2C_SEND_ADDR;
+        i2c->currentStop = sendStop;
+
+        // Send target address
+        *(i2c->D) = (addr << 1) | 1; // address + READ
+
+        // wait for byte
+        while(!(*(i2c->S) & I2C_S_IICIF) && (timeout == 0 || deltaT < timeout));
+        *(i2c->S) = I2C_S_IICIF;
+        if(timeout && deltaT >= timeout)
+        {
             *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
             i2c->currentStatus = I2C_TIMEOUT; // Rx incomplete, mark as timeout
             I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
@@ -832,108 +1531,1754 @@ void i2c_t3::sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size
 
         status = *(i2c->S);
 
-        // check arbitration
-        if(status & I2C_S_ARBL)
-        {
-            i2c->currentStatus = I2C_ARB_LOST;
-            *(i2c->S) = I2C_S_ARBL; // clear arbl flag
-            // TODO: this is clearly not right, after ARBL it should drop into IMM slave mode if IAAS=1
-            //       Right now Rx message would be ignored regardless of IAAS
-            *(i2c->C1) = I2C_C1_IICEN; // change to Rx mode, intr disabled (does this send STOP if ARBL flagged?)
-            I2C_ERR_INC(I2C_ERRCNT_ARBL);
-            if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if ARBL
-            return;
-        }
-        // check if slave ACK'd
-        else if(status & I2C_S_RXAK)
+        // check arbitration
+        if(status & I2C_S_ARBL)
+        {
+            i2c->currentStatus = I2C_ARB_LOST;
+            *(i2c->S) = I2C_S_ARBL; // clear arbl flag
+            // TODO: this is clearly not right, after ARBL it should drop into IMM slave mode if IAAS=1
+            //       Right now Rx message would be ignored regardless of IAAS
+            *(i2c->C1) = I2C_C1_IICEN; // change to Rx mode, intr disabled (does this send STOP if ARBL flagged?)
+            I2C_ERR_INC(I2C_ERRCNT_ARBL);
+            if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if ARBL
+            return;
+        }
+        // check if slave ACK'd
+        else if(status & I2C_S_RXAK)
+        {
+            i2c->currentStatus = I2C_ADDR_NAK; // NAK on Addr
+            *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
+            I2C_ERR_INC(I2C_ERRCNT_ADDR_NAK);
+            if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if NAK
+            return;
+        }
+        else
+        {
+            // Slave addr ACK, change to Rx mode
+            i2c->currentStatus = I2C_RECEIVING;
+            if(i2c->reqCount == 1)
+                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TXAK; // no STOP, Rx, NAK on recv
+            else
+                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST; // no STOP, change to Rx
+            data = *(i2c->D); // dummy read
+
+            // Master receive loop
+            while(i2c->rxCount < i2c->reqCount && i2c->currentStatus == I2C_RECEIVING)
+            {
+                while(!(*(i2c->S) & I2C_S_IICIF) && (timeout == 0 || deltaT < timeout));
+                *(i2c->S) = I2C_S_IICIF;
+                chkTimeout = (timeout != 0 && deltaT >= timeout);
+                // check if 2nd to last byte or timeout
+                if((i2c->rxCount+2) == i2c->reqCount || (chkTimeout && !i2c->timeoutRxNAK))
+                {
+                    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TXAK; // no STOP, Rx, NAK on recv
+                }
+                // if last byte or timeout send STOP
+                if((i2c->rxCount+1) >= i2c->reqCount || (chkTimeout && i2c->timeoutRxNAK))
+                {
+                    i2c->timeoutRxNAK = 0; // clear flag
+                    // change to Tx mode
+                    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
+                    // grab last data
+                    data = *(i2c->D);
+                    rxStore_(i2c, data, 1);
+                    if(i2c->rxPtr == i2c->rxBuffer) i2c->rxBufferLength = i2c->rxCount; // Rx buffer data now readable
+                    if(i2c->currentStop == I2C_STOP) // NAK then STOP
+                    {
+                        if(i2c->stopSettle) delayMicroseconds(i2c->stopSettle); // empirical patch, lets things settle before issuing STOP (not needed at 1MHz+)
+                        *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
+                    }
+                    // else NAK no STOP
+
+                    // Set final status
+                    if(chkTimeout)
+                    {
+                        i2c->currentStatus = I2C_TIMEOUT; // Rx incomplete, mark as timeout
+                        I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
+                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if timeout
+                    }
+                    else
+                    {
+                        i2c->currentStatus = I2C_WAITING; // Rx complete, change to waiting state
+                        if(i2c->user_onReqFromDone != nullptr) i2c->user_onReqFromDone(); // Call Master Rx complete callback
+                    }
+                }
+                else
+                {
+                    // grab next data, not last byte, will ACK
+                    rxStore_(i2c, *(i2c->D), 0);
+                }
+                if(chkTimeout) i2c->timeoutRxNAK = 1; // set flag to indicate NAK sent
+            }
+        }
+    }
+    //
+    // ISR/DMA mode - non-blocking
+    //
+    else if(i2c->opMode == I2C_OP_MODE_ISR || i2c->opMode == I2C_OP_MODE_DMA)
+    {
+        if(defer)
+            deferStart_(i2c, addr, sendStop, I2C_SEND_ADDR);
+        else
+            startRx_(i2c, addr, sendStop);
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Rx - starts ISR/DMA Master receive on an acquired bus, intended for internal use only.  reqCount
+//            bytes are received into rxPtr.
+// return: none
+// parameters:
+//      addr = target 7bit slave address
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//
+void i2c_t3::startRx_(struct i2cStruct* i2c, uint8_t addr, i2c_stop sendStop)
+{
+    // send 1st data and enable interrupts, save target for retry
+    i2c->rxCount = 0;
+    i2c->rxBase = 0;
+    i2c->currentStatus = I2C_SEND_ADDR;
+    i2c->currentStop = sendStop;
+    i2c->curAddr = addr;
+    if(i2c->opMode == I2C_OP_MODE_DMA && i2c->reqCount >= i2c->dmaThreshold && dmaBorrow_(i2c)) // limit short transfers to ISR method
+    {
+        // init DMA, let the hack begin
+        i2c->activeDMA = I2C_DMA_ADDR;
+        i2c->DMA->source(*(i2c->D));
+        i2c->rxDmaLen = i2c->reqCount-1; // DMA gets all except last byte, bulk read one chunk at a time
+        if(i2c->bulk != nullptr && i2c->rxDmaLen > i2c->bulk->chunk) i2c->rxDmaLen = i2c->bulk->chunk;
+        i2c->DMA->destinationBuffer(&i2c->rxPtr[0],i2c->rxDmaLen);
+    }
+    // start ISR
+    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX; // enable intr
+    *(i2c->D) = (addr << 1) | 1; // address + READ
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Queue Transaction - non-blocking routine, appends a transaction descriptor to the bus queue.  Queued
+//                     transactions run back-to-back from the ISR, each starting as soon as the previous
+//                     one completes.  The descriptor and its data buffer must remain valid until done.
+// return: 1=queued, 0=fail (Slave or IMM mode, zero length read, or descriptor already queued)
+// parameters:
+//      txn = transaction descriptor, caller sets addr, rw, data, len
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//
+uint8_t i2c_t3::queue_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* txn, i2c_stop sendStop)
+{
+    // queue runs from ISR, so ISR/DMA Master only, and descriptor cannot be queued twice
+    if(i2c->currentMode == I2C_SLAVE || i2c->opMode == I2C_OP_MODE_IMM) return 0;
+    if(txn->status >= I2C_SENDING || (txn->rw == I2C_READ && txn->len == 0)) return 0;
+
+    // pending coalesced writes to this target run first
+    flushWrites_(i2c, bus, txn->addr, txn);
+
+    txn->stop = sendStop;
+    txn->count = 0;
+    txn->next = nullptr;
+    txn->status = (txn->rw == I2C_READ) ? I2C_SEND_ADDR : I2C_SENDING;
+
+    appendQueue_(i2c, bus, txn, txn);
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Append Queue - inserts a linked chain of prepared transactions into the queue as a single unit, and starts
+//                it if the bus is idle, intended for internal use only.  The queue is kept in scheduling order
+//                (earliest deadline first, then highest priority, then FIFO).  The chain is never inserted
+//                ahead of the active transaction, inside another RepSTART chain, or ahead of a transaction
+//                already passed I2C_SCHED_MAX_BYPASS times.
+// return: none
+// parameters:
+//      first = first transaction in chain
+//      last = last transaction in chain
+//
+void i2c_t3::appendQueue_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* first, struct i2cTransaction* last)
+{
+    struct i2cTransaction* prev = nullptr;
+    struct i2cTransaction* pos;
+    struct i2cTransaction* txn;
+    uint8_t forceImm=0, start;
+    uint32_t primask;
+
+    for(txn = first; txn != nullptr; txn = (txn == last) ? nullptr : txn->next) txn->bypassed = 0;
+
+    I2C_IRQ_SAVE(primask);
+    pos = i2c->qHead;
+    if(i2c->txn != nullptr)
+    {
+        // skip active transaction and rest of its chain
+        for(prev = pos; prev->stop == I2C_NOSTOP && prev->next != nullptr; prev = prev->next);
+        pos = prev->next;
+    }
+    // find first chain which the new chain should run before, only inserting at chain boundaries
+    while(pos != nullptr && (pos->bypassed >= I2C_SCHED_MAX_BYPASS || !schedBefore_(first, pos)))
+    {
+        for(; pos->stop == I2C_NOSTOP && pos->next != nullptr; pos = pos->next);
+        prev = pos;
+        pos = pos->next;
+    }
+    last->next = pos;
+    if(prev == nullptr)
+        i2c->qHead = first;
+    else
+        prev->next = first;
+    if(pos == nullptr) i2c->qTail = last;
+    for(txn = pos; txn != nullptr; txn = txn->next) txn->bypassed++; // passed by new chain
+    // start it here only if it is at head of queue and bus is not running a Tx/Rx
+    start = (i2c->qHead == first && i2c->txn == nullptr && done_(i2c));
+    I2C_IRQ_RESTORE(primask);
+
+    if(start)
+    {
+        // escalate ISR priority as needed (immediate mode not used, as queue never blocks caller)
+        checkPriority_(i2c, bus, forceImm);
+        startQueue_(i2c, bus);
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Schedule Before - returns 1 if transaction a should run before transaction b.  Transactions with a deadline
+//                   run before those without, earliest deadline first (wrap-safe), and ties are broken by
+//                   highest priority.  Equal transactions return 0, so the queue is FIFO among them.
+// return: 1=a before b, 0=otherwise
+// parameters:
+//      a, b = transaction descriptors
+//
+uint8_t i2c_t3::schedBefore_(const struct i2cTransaction* a, const struct i2cTransaction* b)
+{
+    if(a->hasDeadline && b->hasDeadline)
+    {
+        if(a->deadline != b->deadline) return ((int32_t)(a->deadline - b->deadline) < 0);
+    }
+    else if(a->hasDeadline || b->hasDeadline)
+        return a->hasDeadline;
+    return (a->priority > b->priority);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Transfer - blocking routine with timeout, runs a list of messages as one combined transaction.  Messages
+//            are chained with RepSTART and a single STOP is sent after the last message.  In ISR/DMA mode the
+//            whole list is queued as one unit and chained from the ISR.  If a message fails the remaining
+//            messages are not sent and are marked with the same status.
+// return: #messages completed successfully (n = success)
+// parameters:
+//      msgs = array of transaction descriptors, caller sets addr, rw, data, len
+//      n = number of messages
+//      timeout = timeout in microseconds
+//
+size_t i2c_t3::transfer_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* msgs, size_t n, uint32_t timeout)
+{
+    struct i2cTransaction* last;
+    size_t idx, good;
+    uint8_t forceImm=0;
+
+    if(n == 0 || i2c->currentMode == I2C_SLAVE) return 0;
+    for(idx=0; idx < n; idx++)
+        if(msgs[idx].status >= I2C_SENDING || (msgs[idx].rw == I2C_READ && msgs[idx].len == 0)) return 0;
+    last = &msgs[n-1];
+    timeout = (timeout == 0) ? i2c->defTimeout : timeout;
+
+    // if current priority cannot be surpassed the ISR cannot run the chain, so use immediate mode
+    checkPriority_(i2c, bus, forceImm);
+
+    //
+    // Immediate mode - run messages back-to-back as blocking Tx/Rx
+    //
+    if(i2c->opMode == I2C_OP_MODE_IMM || forceImm)
+    {
+        for(idx=0; idx < n; idx++)
+        {
+            struct i2cTransaction* txn = &msgs[idx];
+            i2c_stop sendStop = (txn == last) ? I2C_STOP : I2C_NOSTOP;
+            txn->count = 0;
+            txn->tStart = micros();
+            if(txn->rw == I2C_READ)
+            {
+                txn->count = requestFrom_(i2c, bus, txn->addr, txn->data, txn->len, sendStop, timeout);
+            }
+            else
+            {
+                struct i2cSegment seg = {txn->data, txn->len};
+                sendTransmission_(i2c, bus, txn->addr, &seg, 1, sendStop, timeout);
+                if(finish_(i2c, bus, timeout)) txn->count = txn->len;
+            }
+            i2c_status status = i2c->currentStatus;
+            if(status != I2C_WAITING && (*(i2c->C1) & I2C_C1_MST)) *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode
+            completeTxn_(txn, status);
+            if(status != I2C_WAITING)
+            {
+                for(idx++; idx < n; idx++) { msgs[idx].count = 0; completeTxn_(&msgs[idx], status); }
+                return 0;
+            }
+        }
+        return n;
+    }
+
+    //
+    // ISR/DMA mode - queue list as a single chain, after any pending coalesced writes to its targets
+    //
+    for(idx=0; idx < n; idx++) flushWrites_(i2c, bus, msgs[idx].addr, msgs);
+    prepChain_(msgs, n);
+    appendQueue_(i2c, bus, msgs, last);
+
+    // wait for completion or timeout
+    elapsedMicros deltaT;
+    while(!done(*last) && (timeout == 0 || deltaT < timeout)) wait_(i2c, &last->status);
+
+    if(!done(*last)) abortChain_(i2c, msgs, last);
+
+    for(good=0; good < n && msgs[good].status == I2C_WAITING; good++);
+    return good;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Handle Transfer - non-blocking routine, starts a write, read, or write-then-read tracked by a handle.
+//                         In ISR/DMA mode it is queued as one chain, in IMM mode it runs blocking.
+// return: 1=started, 0=fail (Slave mode, zero length, or handle busy)
+// parameters:
+//      h = transfer handle
+//      addr = target 7bit slave address
+//      txData = pointer to Tx data (nullptr = read only)
+//      txLen = number of Tx bytes
+//      rxBuf = destination buffer (nullptr = write only)
+//      rxLen = number of bytes requested
+//      onDone = done callback for the whole transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+uint8_t i2c_t3::startHandle_(struct i2cStruct* i2c, uint8_t bus, i2cHandle* h, uint8_t addr, const uint8_t* txData,
+                             size_t txLen, uint8_t* rxBuf, size_t rxLen, i2c_done_cb onDone, void* ctx)
+{
+    struct i2cTransaction* msg = h->msgs;
+    uint8_t n = 0;
+
+    if(i2c->currentMode == I2C_SLAVE || !h->done()) return 0;
+    if(txData != nullptr && txLen)
+    {
+        msg[n] = i2cTransaction();
+        msg[n].addr = addr;
+        msg[n].rw = I2C_WRITE;
+        msg[n].data = (uint8_t*)txData; // Tx data is only read
+        msg[n].len = txLen;
+        n++;
+    }
+    if(rxBuf != nullptr && rxLen)
+    {
+        msg[n] = i2cTransaction();
+        msg[n].addr = addr;
+        msg[n].rw = I2C_READ;
+        msg[n].data = rxBuf;
+        msg[n].len = rxLen;
+        n++;
+    }
+    h->n = n;
+    h->i2c = i2c;
+    if(n == 0) return 0; // handle left not started
+    msg[n-1].onDone = onDone;
+    msg[n-1].ctx = ctx;
+
+    // IMM mode runs blocking, ISR/DMA mode queues as single chain
+    if(i2c->opMode == I2C_OP_MODE_IMM)
+    {
+        transfer_(i2c, bus, msg, n, 0);
+        return 1;
+    }
+    flushWrites_(i2c, bus, addr, msg);
+    prepChain_(msg, n);
+    appendQueue_(i2c, bus, &msg[0], &msg[n-1]);
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Handle Wait - blocking routine with timeout, waits for a handle transfer to complete.  On timeout the
+//               transfer is terminated (marked I2C_TIMEOUT).
+// return: 1=success, 0=fail (NAK, timeout, bus error, or not started)
+// parameters:
+//      timeout = timeout in microseconds (0 = infinite wait)
+//
+uint8_t i2cHandle::wait(uint32_t timeout)
+{
+    elapsedMicros deltaT;
+
+    if(n == 0 || i2c == nullptr) return 0; // never started
+
+    while(!done() && (timeout == 0 || deltaT < timeout)) i2c_t3::wait_(i2c, &msgs[n-1].status);
+    if(!done()) i2c_t3::abortChain_(i2c, &msgs[0], &msgs[n-1]);
+    return (status() == I2C_WAITING);
+}
+
+
+#if defined(__cpp_impl_coroutine)
+// ------------------------------------------------------------------------------------------------------
+// Await Suspend - starts an awaited transfer with the coroutine suspended.  If the transfer fails to start,
+//                 or completes before suspension is final (eg. IMM mode), the coroutine is not suspended.
+// return: true=suspended, false=continue coroutine
+// parameters:
+//      c = awaiting coroutine
+//
+bool i2cAwait::await_suspend(std::coroutine_handle<> c)
+{
+    uint32_t primask;
+    bool suspend;
+
+    coro = c;
+    state = 0;
+    next = nullptr;
+    if(!i2c_t3::startHandle_(i2c, bus, &h, addr, txData, txLen, rxBuf, rxLen, i2c_t3::awaitDone_, this))
+    {
+        h.msgs[0].status = I2C_NOT_ACQ; // report failure to start
+        h.n = 1;
+        return false;
+    }
+
+    // suspend unless already done (done callback will not resume it while starting)
+    I2C_IRQ_SAVE(primask);
+    suspend = (state == 0);
+    if(suspend) state = 1;
+    I2C_IRQ_RESTORE(primask);
+    return suspend;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Await Done - done callback of an awaited transfer (from ISR), resumes coroutine directly or adds it to
+//              deferred resume list, intended for internal use only
+// return: none
+// parameters:
+//      ctx = awaitable
+//      status = final status (unused, read from handle on resume)
+//
+void i2c_t3::awaitDone_(void* ctx, i2c_status status)
+{
+    struct i2cAwait* aw = (struct i2cAwait*)ctx;
+    uint32_t primask;
+    uint8_t suspended;
+
+    I2C_IRQ_SAVE(primask);
+    suspended = (aw->state == 1);
+    aw->state = 2;
+    if(suspended && aw->resume == I2C_RESUME_DEFERRED)
+    {
+        // append to deferred resume list
+        if(awaitTail != nullptr)
+            awaitTail->next = aw;
+        else
+            awaitHead = aw;
+        awaitTail = aw;
+    }
+    I2C_IRQ_RESTORE(primask);
+
+    // done callback runs once last message status is set, so handle result is final
+    if(suspended && aw->resume == I2C_RESUME_ISR) aw->coro.resume();
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Dispatch Awaits - resumes coroutines whose awaited transfers have completed (deferred resume)
+// return: number of coroutines resumed
+//
+size_t i2c_t3::dispatchAwaits(void)
+{
+    struct i2cAwait* aw;
+    uint32_t primask;
+    size_t count = 0;
+
+    for(;;)
+    {
+        I2C_IRQ_SAVE(primask);
+        aw = awaitHead;
+        if(aw != nullptr)
+        {
+            awaitHead = aw->next;
+            if(awaitHead == nullptr) awaitTail = nullptr;
+        }
+        I2C_IRQ_RESTORE(primask);
+        if(aw == nullptr) return count;
+        aw->coro.resume(); // awaitable may be destroyed by resume
+        count++;
+    }
+}
+#endif
+
+
+// ------------------------------------------------------------------------------------------------------
+// Abort Chain - terminates a timed out chain of queued transactions (contiguous array), intended for internal
+//               use only.  If the chain is running the active message is marked as timeout (ISR then fails the
+//               rest of the chain) or its DMA is aborted, otherwise the chain is removed from the queue and
+//               marked as timeout.  If the ISR does not retire the chain within 2 byte periods (stuck bus) it
+//               is retired here.  Returns once the chain is done.
+// return: none
+// parameters:
+//      first = first transaction in chain
+//      last = last transaction in chain
+//
+void i2c_t3::abortChain_(struct i2cStruct* i2c, struct i2cTransaction* first, struct i2cTransaction* last)
+{
+    struct i2cTransaction* prev = nullptr;
+    struct i2cTransaction* drop = nullptr;
+    struct i2cTransaction* pos;
+    uint8_t bus = (uint8_t)(i2c - i2cData);
+    uint32_t primask;
+    uint8_t cancel=0, dma=0;
+
+    I2C_IRQ_SAVE(primask);
+    if(i2c->txn >= first && i2c->txn <= last)
+    {
+        // pending retry has no ISR to retire it, so cancel and retire here
+        cancel = cancelPending_(i2c);
+        if(i2c->activeDMA == I2C_DMA_OFF)
+            i2c->currentStatus = I2C_TIMEOUT;
+        else
+            dma = 1; // abort DMA and recover bus, as in finish_()
+    }
+    else
+    {
+        // find pending part of chain and remove it from queue
+        for(pos = i2c->qHead; pos != nullptr && !(pos >= first && pos <= last); prev = pos, pos = pos->next);
+        if(pos != nullptr)
+        {
+            drop = pos;
+            if(prev == nullptr)
+                i2c->qHead = last->next;
+            else
+                prev->next = last->next;
+            if(i2c->qTail == last) i2c->qTail = prev;
+            I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
+        }
+    }
+    I2C_IRQ_RESTORE(primask);
+    if(dma)
+    {
+        // DMA abort disables intr, so no ISR will retire the transaction
+        dmaAbort_(i2c, bus);
+        dmaReturn_(i2c);
+    }
+    if(cancel || dma) serviceQueue_(i2c, bus);
+    for(; drop != nullptr && drop <= last; drop++)
+        completeTxn_(drop, I2C_TIMEOUT);
+
+    // wait for ISR to retire chain, bounded to 2 byte periods
+    elapsedMicros deltaT;
+    uint32_t timeout = 20000000/i2c->currentRate + 1;
+    while(!done(*last) && deltaT < timeout) wait_(i2c, &last->status);
+    if(done(*last)) return;
+
+    // no ISR (stuck bus), release bus and retire rest of chain here
+    I2C_IRQ_SAVE(primask);
+    if(i2c->txn >= first && i2c->txn <= last)
+    {
+        *(i2c->C1) = I2C_C1_IICEN; // send STOP if Master, change to Rx mode, intr disabled
+        *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+        i2c->currentStatus = I2C_TIMEOUT;
+        cancel = 1;
+    }
+    else
+        cancel = 0;
+    I2C_IRQ_RESTORE(primask);
+    if(!cancel) return; // retired meanwhile
+    deltaT = 0;
+    while((*(i2c->S) & I2C_S_BUSY) && deltaT < i2c->stopWait);
+    if(*(i2c->S) & I2C_S_BUSY)
+    {
+        resetBus_(i2c, bus);
+        i2c->currentStatus = I2C_TIMEOUT;
+    }
+    I2C_IRQ_SAVE(primask);
+    serviceQueue_(i2c, bus); // retires active message and rest of chain up to STOP
+    I2C_IRQ_RESTORE(primask);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Send Group - non-blocking routine, starts a group of transfers spread over several buses, so that they run
+//              concurrently.  Each item is a message list run as one combined transaction (as in transfer())
+//              on its bus.  Items on ISR/DMA buses are queued first, then items on IMM buses (or where the
+//              caller priority cannot be surpassed) are run blocking.  Use finishGroup() to wait for the group.
+// return: none
+// parameters:
+//      items = array of group items, caller sets bus, msgs, n
+//      n = number of items
+//
+void i2c_t3::sendGroup(i2cGroupItem* items, size_t n)
+{
+    struct i2cStruct* i2c;
+    struct i2cGroupItem* item;
+    size_t idx, msg;
+    uint8_t pass, forceImm;
+
+    for(pass=0; pass < 2; pass++)
+    {
+        for(idx=0; idx < n; idx++)
+        {
+            item = &items[idx];
+            if(pass == 0)
+            {
+                // validate item
+                item->status = I2C_SENDING;
+                item->good = 0;
+                item->elapsed = 0;
+                if(item->bus >= I2C_BUS_NUM || item->n == 0 || i2cData[item->bus].currentMode == I2C_SLAVE)
+                    { item->status = I2C_NOT_ACQ; continue; }
+                for(msg=0; msg < item->n; msg++)
+                    if(item->msgs[msg].status >= I2C_SENDING || (item->msgs[msg].rw == I2C_READ && item->msgs[msg].len == 0))
+                        break;
+                if(msg < item->n) { item->status = I2C_NOT_ACQ; continue; }
+            }
+            else if(item->status != I2C_SENDING)
+                continue;
+            i2c = &i2cData[item->bus];
+            forceImm = 0;
+            checkPriority_(i2c, item->bus, forceImm);
+            if(i2c->opMode == I2C_OP_MODE_IMM || forceImm)
+            {
+                // blocking item, run on second pass
+                if(pass == 1)
+                {
+                    item->tStart = micros();
+                    transfer_(i2c, item->bus, item->msgs, item->n, 0);
+                }
+            }
+            else if(pass == 0)
+            {
+                // background item, queue as single chain
+                item->tStart = micros();
+                for(msg=0; msg < item->n; msg++) flushWrites_(i2c, item->bus, item->msgs[msg].addr, item->msgs);
+                prepChain_(item->msgs, item->n);
+                appendQueue_(i2c, item->bus, item->msgs, &item->msgs[item->n-1]);
+            }
+        }
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Finish Group - blocking routine with timeout, waits for all transfers of a group started by sendGroup(), and
+//                sets per-item results.  Items which do not complete within the timeout are terminated.
+// return: #items completed successfully (n = success)
+// parameters:
+//      items = array of group items
+//      n = number of items
+//      timeout = timeout in microseconds (0 = infinite wait)
+//
+size_t i2c_t3::finishGroup(i2cGroupItem* items, size_t n, uint32_t timeout)
+{
+    struct i2cGroupItem* item;
+    struct i2cTransaction* last;
+    size_t idx, good=0, pending;
+    elapsedMicros deltaT;
+
+    // wait for all items (join), using wait strategy of a pending item's bus
+    for(;;)
+    {
+        for(pending=0, item=nullptr, idx=0; idx < n; idx++)
+            if(items[idx].status == I2C_SENDING && !done(items[idx].msgs[items[idx].n-1])) { pending++; item = &items[idx]; }
+        if(!pending || (timeout && deltaT >= timeout)) break;
+        wait_(&i2cData[item->bus], &item->msgs[item->n-1].status);
+    }
+
+    for(idx=0; idx < n; idx++)
+    {
+        item = &items[idx];
+        if(item->status != I2C_SENDING) continue; // invalid item
+        last = &item->msgs[item->n-1];
+        if(!done(*last)) abortChain_(&i2cData[item->bus], item->msgs, last);
+
+        // per-item results
+        for(item->good=0; item->good < item->n && item->msgs[item->good].status == I2C_WAITING; item->good++);
+        item->status = (item->good < item->n) ? item->msgs[item->good].status : I2C_WAITING;
+        item->elapsed = last->tDone - item->tStart;
+        if(item->status == I2C_WAITING) good++;
+    }
+    return good;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Queue - starts transaction at head of queue, intended for internal use only.  This does not block
+//               on a busy bus.  If previous transaction ended with I2C_NOSTOP a RepSTART is sent.  If bus
+//               is busy (eg. previous STOP still in progress, or another Master) then on LC/3.5/3.6 it will
+//               resume on STOP detect interrupt.  3.0/3.1/3.2 have no STOP detect so they wait for the
+//               bus to free (bounded to a few bit periods if in ISR, default timeout otherwise).
+// return: none
+//
+void i2c_t3::startQueue_(struct i2cStruct* i2c, uint8_t bus)
+{
+    struct i2cTransaction* txn;
+    uint32_t primask;
+
+    while((txn = i2c->qHead) != nullptr)
+    {
+        // claim head transaction (mark bus active so ISR will not retire or restart it)
+        I2C_IRQ_SAVE(primask);
+        if(i2c->txn != nullptr || !done_(i2c)) { I2C_IRQ_RESTORE(primask); return; }
+        i2c->txn = txn;
+        i2c->currentStatus = txn->status;
+        txn->tStart = micros();
+        i2c->txBufferIndex = 0;
+        i2c->rxCount = 0;
+        i2c->retryCount = 0;
+        I2C_IRQ_RESTORE(primask);
+
+        // clear the status flags
+        #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+            *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
+        #endif
+        *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+
+        // take control of the bus
+        if(*(i2c->C1) & I2C_C1_MST)
+        {
+            // we are already the bus master, so send a repeated start
+            i2c->repStart = 1;
+            *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_RSTA | I2C_C1_TX;
+        }
+        else
+        {
+            i2c->repStart = 0;
+            #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+                if(*(i2c->S) & I2C_S_BUSY)
+                {
+                    // bus busy, enable STOP detect intr and restart from ISR when bus frees
+                    *(i2c->FLT) |= I2C_FLT_SSIE;
+                    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE;
+                    if(*(i2c->S) & I2C_S_BUSY)
+                    {
+                        i2c->currentStatus = I2C_WAITING; // release claim, ISR will restart on STOP
+                        i2c->txn = nullptr;
+                        return;
+                    }
+                    // STOP completed while enabling intr, proceed
+                }
+                *(i2c->FLT) &= ~I2C_FLT_SSIE; // disable STOP/START intr (not used in Master mode)
+            #else
+                // wait for bus to free, if called from any ISR (I2C, DMA, or job/retry timer) limit wait to
+                // 4 bit periods (STOP to complete)
+                elapsedMicros deltaT;
+                uint32_t ipsr, timeout;
+                __asm__ volatile("mrs %0, ipsr\n" : "=r" (ipsr));
+                timeout = (ipsr != 0 || i2c_t3::isrActive) ? (4000000/i2c->currentRate + 1) : i2c->defTimeout;
+                while((*(i2c->S) & I2C_S_BUSY) && (timeout == 0 || deltaT < timeout));
+            #endif
+            if(*(i2c->S) & I2C_S_BUSY)
+            {
+                // bus not acquired, fail transaction and try next
+                *(i2c->C1) = I2C_C1_IICEN; // intr disabled
+                i2c->currentStatus = I2C_NOT_ACQ;
+                I2C_ERR_INC(I2C_ERRCNT_NOT_ACQ);
+                if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if cannot acquire bus
+                retireQueue_(i2c);
+                continue;
+            }
+            // become the bus master in transmit mode (send start)
+            i2c->currentMode = I2C_MASTER;
+            *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
+        }
+
+        // start transfer using descriptor buffer
+        i2c->bulk = nullptr;
+        if(txn->rw == I2C_READ)
+        {
+            i2c->rxPtr = txn->data;
+            i2c->reqCount = txn->len;
+            startRx_(i2c, txn->addr, txn->stop);
+        }
+        else
+        {
+            i2c->txSegBuf.data = txn->data;
+            i2c->txSegBuf.len = txn->len;
+            i2c->txSeg = &i2c->txSegBuf;
+            i2c->txSegIndex = 0;
+            i2c->txLength = txn->len + 1;
+            startTx_(i2c, (uint8_t)(txn->addr << 1), txn->stop);
+        }
+        return;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Service Queue - retires completed transaction and starts next one, intended for internal use only.
+//                 Called at the end of every I2C ISR.
+// return: none
+//
+void i2c_t3::serviceQueue_(struct i2cStruct* i2c, uint8_t bus)
+{
+    // retire completed transaction
+    if(i2c->txn != nullptr && done_(i2c))
+        retireQueue_(i2c);
+
+    // start next transaction
+    if(i2c->txn == nullptr && i2c->qHead != nullptr && done_(i2c))
+        startQueue_(i2c, bus);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Retire Queue - records result of the active transaction and removes it from the queue, intended for
+//                internal use only
+// return: none
+//
+void i2c_t3::retireQueue_(struct i2cStruct* i2c)
+{
+    struct i2cTransaction* txn = i2c->txn;
+
+    if(txn->rw == I2C_READ)
+        txn->count = i2c->rxCount;
+    else
+        txn->count = (i2c->txBufferIndex) ? i2c->txBufferIndex-1 : 0; // exclude addr byte
+    i2c->qHead = txn->next;
+    i2c->txn = nullptr;
+
+    // record deadline miss
+    if(txn->hasDeadline && (int32_t)(micros() - txn->deadline) > 0)
+        I2C_ERR_INC(I2C_ERRCNT_DEADLINE);
+
+    // failed transaction in a RepSTART chain, fail rest of chain (up to and including next STOP) and release bus
+    if(i2c->currentStatus != I2C_WAITING && txn->stop == I2C_NOSTOP)
+    {
+        struct i2cTransaction* next;
+        i2c_stop stop;
+        while((next = i2c->qHead) != nullptr)
+        {
+            i2c->qHead = next->next;
+            stop = next->stop;
+            next->count = 0;
+            completeTxn_(next, i2c->currentStatus);
+            if(stop == I2C_STOP) break;
+        }
+        if(*(i2c->C1) & I2C_C1_MST) *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
+    }
+    if(i2c->qHead == nullptr) i2c->qTail = nullptr;
+    completeTxn_(txn, i2c->currentStatus);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Complete Transaction - sets final status of a transaction and runs its done callback, intended for
+//                        internal use only.  Status is set last, as descriptor can be reused once set.
+// return: none
+// parameters:
+//      txn = transaction descriptor
+//      status = final status
+//
+void i2c_t3::completeTxn_(struct i2cTransaction* txn, i2c_status status)
+{
+    i2c_done_cb onDone = txn->onDone;
+    void* ctx = txn->ctx;
+
+    txn->tDone = micros();
+    txn->status = status;
+    if(onDone != nullptr) onDone(ctx, status);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Call Done - runs and disarms the done callback of a background Tx/Rx once it is complete, intended for
+//             internal use only.  Safe to call from both ISR and foreground (callback runs once).
+// return: none
+//
+void i2c_t3::callDone_(struct i2cStruct* i2c)
+{
+    i2c_done_cb onDone;
+    uint32_t primask;
+
+    I2C_IRQ_SAVE(primask);
+    onDone = i2c->doneCb;
+    if(onDone != nullptr && done_(i2c))
+        i2c->doneCb = nullptr;
+    else
+        onDone = nullptr;
+    I2C_IRQ_RESTORE(primask);
+    if(onDone != nullptr) onDone(i2c->doneCtx, i2c->currentStatus);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Clear Queue - removes all pending transactions from the queue (an active transaction will run to
+//               completion).  Removed transactions are marked I2C_NOT_ACQ.
+// return: none
+//
+void i2c_t3::clearQueue_(struct i2cStruct* i2c)
+{
+    struct i2cTransaction* txn;
+    uint32_t primask;
+
+    I2C_IRQ_SAVE(primask);
+    txn = (i2c->txn != nullptr) ? i2c->txn->next : i2c->qHead;
+    if(i2c->txn != nullptr)
+    {
+        i2c->txn->next = nullptr;
+        i2c->qTail = i2c->txn;
+    }
+    else
+        i2c->qHead = i2c->qTail = nullptr;
+    I2C_IRQ_RESTORE(primask);
+
+    while(txn != nullptr)
+    {
+        struct i2cTransaction* next = txn->next;
+        completeTxn_(txn, I2C_NOT_ACQ);
+        txn = next;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Prepare Chain - prepares an array of transactions as a RepSTART chain (STOP after last), intended for
+//                 internal use only
+// return: none
+// parameters:
+//      msgs = array of transaction descriptors
+//      n = number of transactions
+//
+void i2c_t3::prepChain_(struct i2cTransaction* msgs, size_t n)
+{
+    for(size_t idx=0; idx < n; idx++)
+    {
+        msgs[idx].stop = (idx == n-1) ? I2C_STOP : I2C_NOSTOP;
+        msgs[idx].count = 0;
+        msgs[idx].next = (idx == n-1) ? nullptr : &msgs[idx+1];
+        msgs[idx].status = (msgs[idx].rw == I2C_READ) ? I2C_SEND_ADDR : I2C_SENDING;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Write Register - buffers a single register write to a target, merging it with pending writes to contiguous
+//                  registers of the same target.  Pending writes are sent before any other Tx/Rx to that
+//                  target, or by flushWrites().
+// return: 1=buffered, 0=fail (Slave mode)
+// parameters:
+//      addr = target 7bit slave address
+//      reg = register address
+//      data = register value
+//
+uint8_t i2c_t3::writeReg_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t reg, uint8_t data)
+{
+    struct i2cCoalesce* slot;
+    uint32_t primask;
+    uint8_t idx, merged=0;
+    int offset;
+
+    if(i2c->currentMode == I2C_SLAVE) return 0;
+
+    // merge into pending burst for this target (rewrite or append), slot may be flushed from ISR so protect
+    for(idx=0; idx < I2C_COALESCE_SLOTS; idx++)
+    {
+        slot = &i2c->coalesce[idx];
+        I2C_IRQ_SAVE(primask);
+        if(slot->len && slot->addr == addr)
+        {
+            offset = (int)reg - slot->buf[0];
+            if(offset >= 0 && offset < slot->len)
+                { slot->buf[1+offset] = data; merged = 1; }
+            else if(offset == slot->len && slot->len < I2C_COALESCE_LENGTH)
+                { slot->buf[1+slot->len] = data; slot->len++; merged = 1; }
+            else
+                merged = 2; // not contiguous or full
+        }
+        I2C_IRQ_RESTORE(primask);
+        if(merged == 1) return 1;
+        if(merged == 2) { flushWrites_(i2c, bus, addr); break; }
+    }
+
+    // find free slot (empty and not sending), if all are busy send a pending burst and wait
+    slot = nullptr;
+    while(slot == nullptr)
+    {
+        for(idx=0; idx < I2C_COALESCE_SLOTS && slot == nullptr; idx++)
+            if(i2c->coalesce[idx].len == 0 && done(i2c->coalesce[idx].txn)) slot = &i2c->coalesce[idx];
+        if(slot != nullptr) break;
+        for(idx=0; idx < I2C_COALESCE_SLOTS && !i2c->coalesce[idx].len; idx++);
+        if(idx < I2C_COALESCE_SLOTS)
+            flushWrites_(i2c, bus, i2c->coalesce[idx].addr); // send a pending burst to free its slot
+        else
+            wait_(i2c); // all slots sending, wait for one to complete
+    }
+    slot->addr = addr;
+    slot->buf[0] = reg;
+    slot->buf[1] = data;
+    slot->len = 1;
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Flush Writes - sends pending coalesced writes to a target (or all targets), without waiting.  In ISR/DMA
+//                mode each burst is queued using the deadline and priority of ref (if given), so it runs
+//                ahead of ref.  In IMM mode each burst is sent blocking.  Intended for internal use only.
+// return: none
+// parameters:
+//      addr = target 7bit slave address (addr > 0x7F = all targets)
+//      ref = transaction to run ahead of (nullptr = none)
+//
+void i2c_t3::flushWrites_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const struct i2cTransaction* ref)
+{
+    struct i2cCoalesce* slot;
+    uint32_t primask;
+    size_t len;
+
+    for(uint8_t idx=0; idx < I2C_COALESCE_SLOTS; idx++)
+    {
+        slot = &i2c->coalesce[idx];
+
+        // claim pending burst, marking it sending so slot is not reused until complete
+        len = 0;
+        I2C_IRQ_SAVE(primask);
+        if(slot->len && (addr > 0x7F || slot->addr == addr))
+        {
+            len = slot->len + 1; // include register addr
+            slot->len = 0;
+            slot->txn.status = I2C_SENDING;
+        }
+        I2C_IRQ_RESTORE(primask);
+        if(!len) continue;
+
+        slot->txn.addr = slot->addr;
+        slot->txn.rw = I2C_WRITE;
+        slot->txn.data = slot->buf;
+        slot->txn.len = len;
+        slot->txn.onDone = nullptr;
+        slot->txn.deadline = (ref != nullptr) ? ref->deadline : 0;
+        slot->txn.hasDeadline = (ref != nullptr) ? ref->hasDeadline : 0;
+        slot->txn.priority = (ref != nullptr) ? ref->priority : 0;
+        if(i2c->opMode == I2C_OP_MODE_IMM || i2c->currentMode == I2C_SLAVE)
+        {
+            struct i2cSegment seg = {slot->buf, len};
+            sendTransmission_(i2c, bus, slot->txn.addr, &seg, 1, I2C_STOP, 0);
+            slot->txn.count = finish_(i2c, bus, 0) ? len : 0;
+            slot->txn.status = i2c->currentStatus;
+        }
+        else
+        {
+            prepChain_(&slot->txn, 1);
+            appendQueue_(i2c, bus, &slot->txn, &slot->txn);
+        }
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Flush Writes - blocking routine, sends pending coalesced writes on this bus and waits for them to complete
+// return: 1=all writes successful, 0=one or more writes failed
+// parameters:
+//      addr = target 7bit slave address (addr > 0x7F = all targets)
+//
+uint8_t i2c_t3::flushWrites(uint8_t addr)
+{
+    struct i2cCoalesce* slot;
+    uint8_t idx, ok=1;
+
+    flushWrites_(i2c, bus, addr);
+    for(idx=0; idx < I2C_COALESCE_SLOTS; idx++)
+    {
+        slot = &i2c->coalesce[idx];
+        if(addr > 0x7F || slot->addr == addr)
+        {
+            while(!done(slot->txn)) wait_(i2c, &slot->txn.status);
+            if(slot->txn.status != I2C_WAITING) ok = 0;
+            slot->txn.status = I2C_WAITING; // report each failure once
+        }
+    }
+    return ok;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Defer Start - arms STOP detect interrupt to start a loaded background Tx/Rx once the bus is free (the ISR
+//               issues the START).  The transfer is in progress from this point.  Intended for internal use only.
+// return: none
+// parameters:
+//      addr = target 7bit slave address
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      state = I2C_SENDING (Tx), I2C_SEND_ADDR (Rx)
+//
+void i2c_t3::deferStart_(struct i2cStruct* i2c, uint8_t addr, i2c_stop sendStop, i2c_status state)
+{
+    uint32_t primask;
+
+    i2c->curAddr = addr;
+    i2c->currentStop = sendStop;
+    i2c->txSegFirst = i2c->txSeg;
+    I2C_IRQ_SAVE(primask);
+    i2c->currentStatus = state;
+    #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+        *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
+        *(i2c->FLT) |= I2C_FLT_SSIE;                    // enable STOP/START intr
+    #endif
+    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE; // intr enabled, not master
+    if(*(i2c->S) & I2C_S_BUSY)
+        i2c->acqWait = 1; // ISR will start on STOP
+    else
+        restart_(i2c); // STOP completed while arming, start now
+    I2C_IRQ_RESTORE(primask);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Restart - takes the bus and (re)starts the loaded background Tx/Rx from the beginning, intended for internal
+//           use only.  Bus must be free.
+// return: none
+//
+void i2c_t3::restart_(struct i2cStruct* i2c)
+{
+    // clear the status flags
+    #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+        *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
+        *(i2c->FLT) &= ~I2C_FLT_SSIE;                   // disable STOP/START intr (not used in Master mode)
+    #endif
+    *(i2c->S) = I2C_S_IICIF | I2C_S_ARBL; // clear intr, arbl
+
+    // become the bus master in transmit mode (send start), then start transfer
+    i2c->currentMode = I2C_MASTER;
+    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
+    if(i2c->currentStatus == I2C_SENDING)
+    {
+        i2c->txSeg = i2c->txSegFirst;
+        i2c->txSegIndex = 0;
+        startTx_(i2c, (uint8_t)(i2c->curAddr << 1), i2c->currentStop);
+    }
+    else
+        startRx_(i2c, i2c->curAddr, i2c->currentStop);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Wait Step - performs one step of a blocking wait using the bus wait strategy.  Outside of thread mode (ISR
+//             or callback) it always spins, as other strategies may not be valid there, and a lower priority
+//             I2C interrupt could not wake a WFI.
+// return: none
+// parameters:
+//      status = status being waited on (nullptr = none)
+//
+void i2c_t3::wait_(struct i2cStruct* i2c, const volatile i2c_status* status)
+{
+    uint32_t ipsr, primask;
+
+    __asm__ volatile("mrs %0, ipsr\n" : "=r" (ipsr));
+    if(ipsr != 0 || isrActive) return; // spin
+
+    switch(i2c->waitMode)
+    {
+    case I2C_WAIT_YIELD:
+        yield();
+        break;
+    case I2C_WAIT_WFI:
+        // check and sleep with interrupts masked, a pending interrupt still wakes WFI and runs on restore
+        I2C_IRQ_SAVE(primask);
+        if(status == nullptr || *status >= I2C_SENDING) __asm__ volatile("wfi");
+        I2C_IRQ_RESTORE(primask);
+        break;
+    case I2C_WAIT_USER:
+        if(i2c->waitFn != nullptr) i2c->waitFn();
+        break;
+    default:
+        break;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Set Retry Policy - sets automatic retry of failed Master transfers to a target
+// return: 1=success, 0=fail (no free policy slot)
+// parameters:
+//      addr = target 7bit slave address
+//      attempts = max number of attempts including the first (0 or 1 = remove policy)
+//      delay = backoff time in microseconds before first retry
+//      backoff = I2C_BACKOFF_FIXED, I2C_BACKOFF_EXP
+//      retryOn = retryable status mask (OR of I2C_RETRY_ADDR_NAK, I2C_RETRY_DATA_NAK, I2C_RETRY_ARB_LOST,
+//                I2C_RETRY_DMA_ERR)
+//
+uint8_t i2c_t3::setRetryPolicy_(struct i2cStruct* i2c, uint8_t addr, uint8_t attempts, uint32_t delay,
+                                i2c_backoff backoff, uint8_t retryOn)
+{
+    struct i2cRetryPolicy* policy = nullptr;
+    uint32_t primask;
+    uint8_t idx;
+
+    // find existing policy for addr, or free slot
+    for(idx=0; idx < I2C_RETRY_POLICIES; idx++)
+    {
+        if(i2c->retry[idx].attempts && i2c->retry[idx].addr == addr) { policy = &i2c->retry[idx]; break; }
+        if(!i2c->retry[idx].attempts && policy == nullptr) policy = &i2c->retry[idx];
+    }
+    if(policy == nullptr) return (attempts <= 1); // removing a policy which does not exist is not an error
+
+    // update policy, ISR may be reading it
+    I2C_IRQ_SAVE(primask);
+    policy->addr = addr;
+    policy->retryOn = retryOn & I2C_RETRY_ALL;
+    policy->backoff = backoff;
+    policy->delay = delay;
+    policy->attempts = (attempts <= 1) ? 0 : attempts;
+    I2C_IRQ_RESTORE(primask);
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Retry Check - called from ISR when a Master transfer fails.  If the target has a retry policy which allows
+//               another attempt, the transfer is kept in progress and the retry timer restarts it once the
+//               backoff expires.  Intended for internal use only.
+// return: 1=retry pending (error not reported), 0=no retry
+// parameters:
+//      state = in-progress status of the transfer (I2C_SENDING, I2C_SEND_ADDR)
+//
+uint8_t i2c_t3::retryCheck_(struct i2cStruct* i2c, i2c_status state)
+{
+    struct i2cRetryPolicy* policy = nullptr;
+    uint32_t delay, primask;
+    uint8_t idx;
+
+    // a transfer which began with a RepSTART cannot be restarted on its own, and a bulk transfer cannot replay
+    // data already refilled or drained
+    if(i2c->repStart || i2c->bulk != nullptr) return 0;
+    for(idx=0; idx < I2C_RETRY_POLICIES && policy == nullptr; idx++)
+        if(i2c->retry[idx].attempts && i2c->retry[idx].addr == i2c->curAddr) policy = &i2c->retry[idx];
+    if(policy == nullptr || !(policy->retryOn & (1 << i2c->currentStatus)) || i2c->retryCount+1 >= policy->attempts)
+        return 0;
+
+    // backoff, doubled on each retry if exponential
+    delay = policy->delay;
+    if(policy->backoff == I2C_BACKOFF_EXP) delay <<= (i2c->retryCount < 16) ? i2c->retryCount : 16;
+    i2c->retryCount++;
+    i2c->retryAt = micros() + delay;
+    i2c->activeDMA = I2C_DMA_OFF;
+    i2c->currentStatus = state; // keep transfer in progress
+    i2c->retryWait = 1;
+
+    // start retry timer if not running
+    I2C_IRQ_SAVE(primask);
+    if(!retryTimerOn)
+    {
+        retryTimerOn = 1;
+        retryTimer.begin(retryTick_, (uint32_t)I2C_RETRY_TICK);
+    }
+    I2C_IRQ_RESTORE(primask);
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Retry Tick - retry timer ISR, restarts transfers whose backoff has expired (if bus is busy the restart is
+//              tried on the next tick), and stops the timer when no retries are pending.  The transfer is
+//              restarted from its saved target, segments or Rx destination, and STOP setting.  Intended for
+//              internal use only.
+// return: none
+//
+void i2c_t3::retryTick_(void)
+{
+    struct i2cStruct* i2c;
+    uint32_t primask;
+    uint8_t bus, pending=0;
+
+    for(bus=0; bus < I2C_BUS_NUM; bus++)
+    {
+        i2c = &i2cData[bus];
+        I2C_IRQ_SAVE(primask);
+        if(!i2c->retryWait || (int32_t)(micros() - i2c->retryAt) < 0 || (*(i2c->S) & I2C_S_BUSY))
+        {
+            pending |= i2c->retryWait;
+            I2C_IRQ_RESTORE(primask);
+            continue;
+        }
+        i2c->retryWait = 0;
+        I2C_IRQ_RESTORE(primask);
+        restart_(i2c);
+    }
+
+    // stop timer when no retries are pending
+    I2C_IRQ_SAVE(primask);
+    if(!pending)
+    {
+        for(bus=0; bus < I2C_BUS_NUM; bus++) pending |= i2cData[bus].retryWait;
+        if(!pending)
+        {
+            retryTimer.end();
+            retryTimerOn = 0;
+        }
+    }
+    I2C_IRQ_RESTORE(primask);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Cancel Pending - cancels a pending retry or deferred START (eg. on timeout), marking the transfer as timeout,
+//                  intended for internal use only
+// return: 1=cancelled, 0=nothing pending
+//
+uint8_t i2c_t3::cancelPending_(struct i2cStruct* i2c)
+{
+    uint32_t primask;
+    uint8_t cancel;
+
+    I2C_IRQ_SAVE(primask);
+    cancel = i2c->retryWait | i2c->acqWait;
+    if(cancel)
+    {
+        #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+            if(i2c->acqWait) *(i2c->FLT) &= ~I2C_FLT_SSIE; // disable STOP/START intr
+        #endif
+        i2c->retryWait = 0;
+        i2c->acqWait = 0;
+        i2c->currentStatus = I2C_TIMEOUT;
+        I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
+    }
+    I2C_IRQ_RESTORE(primask);
+    return cancel;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Add Job - starts a periodic job on a bus.  The job is run from a timer interrupt, which queues its transfer
+//           to the bus ISR.
+// return: 1=added, 0=fail (Slave or IMM mode, zero period or length, or job already active)
+// parameters:
+//      job = job descriptor, caller sets addr, txData, txLen, rxBuf, rxLen, period
+//
+uint8_t i2c_t3::addJob_(struct i2cStruct* i2c, uint8_t bus, struct i2cJob* job)
+{
+    struct i2cJob* ptr;
+    uint32_t primask;
+
+    // jobs run from ISR, so ISR/DMA Master only
+    if(i2c->currentMode == I2C_SLAVE || i2c->opMode == I2C_OP_MODE_IMM) return 0;
+    if(job->period == 0 || (job->txLen == 0 && job->rxLen == 0)) return 0;
+    for(ptr = jobList; ptr != nullptr; ptr = ptr->next)
+        if(ptr == job) return 0;
+
+    // init job, messages start as done
+    job->i2c = i2c;
+    job->bus = bus;
+    job->front = 0;
+    job->seq = 0;
+    job->overruns = 0;
+    job->status = I2C_WAITING;
+    job->countdown = 0;
+    memset(job->msgs, 0, sizeof(job->msgs));
+
+    // add to job list, and update timer
+    I2C_IRQ_SAVE(primask);
+    job->next = jobList;
+    jobList = job;
+    I2C_IRQ_RESTORE(primask);
+    jobTimerUpdate_();
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Remove Job - stops a periodic job.  A run in progress is allowed to complete (this waits for it).
+// return: none
+// parameters:
+//      job = job descriptor
+//
+void i2c_t3::removeJob(i2cJob& job)
+{
+    struct i2cJob* volatile* link;
+    uint32_t primask;
+
+    I2C_IRQ_SAVE(primask);
+    for(link = &jobList; *link != nullptr && *link != &job; link = &((*link)->next));
+    if(*link != nullptr) *link = job.next;
+    I2C_IRQ_RESTORE(primask);
+    jobTimerUpdate_();
+
+    // wait for run in progress
+    while(!done(job.msgs[0]) || !done(job.msgs[1])) wait_(job.i2c);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Read Job - copies latest complete Rx sample of a periodic job (rxLen bytes).  The copy is retried if a new
+//            sample completes while copying.
+// return: sample number (job.seq of copied sample), 0=no sample yet
+// parameters:
+//      job = job descriptor
+//      dest = destination buffer, rxLen bytes
+//
+uint32_t i2c_t3::readJob(const i2cJob& job, uint8_t* dest)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = job.seq;
+        if(seq == 0) return 0;
+        memcpy(dest, &job.rxBuf[job.front * job.rxLen], job.rxLen);
+    } while(seq != job.seq);
+    return seq;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Job Timer Update - sets job timer to greatest common divisor of active job periods (limited to
+//                    I2C_JOB_MIN_TICK), or stops it if no jobs are active, intended for internal use only
+// return: none
+//
+void i2c_t3::jobTimerUpdate_(void)
+{
+    struct i2cJob* job;
+    uint32_t tick=0, a, b, primask;
+
+    for(job = jobList; job != nullptr; job = job->next)
+    {
+        // gcd of periods
+        for(a = job->period, b = tick; b != 0; ) { uint32_t t = a % b; a = b; b = t; }
+        tick = a;
+    }
+    if(tick == 0)
+    {
+        jobTimer.end();
+        jobTickPeriod = 0;
+        return;
+    }
+    if(tick < I2C_JOB_MIN_TICK) tick = I2C_JOB_MIN_TICK;
+
+    // reload countdowns in new tick units (jobs run on first tick)
+    I2C_IRQ_SAVE(primask);
+    for(job = jobList; job != nullptr; job = job->next)
+        if(tick != jobTickPeriod || job->countdown == 0) job->countdown = 1;
+    I2C_IRQ_RESTORE(primask);
+    if(tick != jobTickPeriod)
+    {
+        jobTickPeriod = tick;
+        jobTimer.begin(jobTick_, tick);
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Job Tick - job timer ISR, runs jobs which are due, intended for internal use only
+// return: none
+//
+void i2c_t3::jobTick_(void)
+{
+    struct i2cJob* job;
+
+    for(job = jobList; job != nullptr; job = job->next)
+    {
+        if(--job->countdown == 0)
         {
-            i2c->currentStatus = I2C_ADDR_NAK; // NAK on Addr
-            *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
-            I2C_ERR_INC(I2C_ERRCNT_ADDR_NAK);
-            if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if NAK
-            return;
+            job->countdown = (job->period + jobTickPeriod/2) / jobTickPeriod; // reload, nearest tick
+            if(job->countdown == 0) job->countdown = 1;
+            runJob_(job);
         }
-        else
-        {
-            // Slave addr ACK, change to Rx mode
-            i2c->currentStatus = I2C_RECEIVING;
-            if(i2c->reqCount == 1)
-                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TXAK; // no STOP, Rx, NAK on recv
-            else
-                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST; // no STOP, change to Rx
-            data = *(i2c->D); // dummy read
+    }
+}
 
-            // Master receive loop
-            while(i2c->rxBufferLength < i2c->reqCount && i2c->currentStatus == I2C_RECEIVING)
-            {
-                while(!(*(i2c->S) & I2C_S_IICIF) && (timeout == 0 || deltaT < timeout));
-                *(i2c->S) = I2C_S_IICIF;
-                chkTimeout = (timeout != 0 && deltaT >= timeout);
-                // check if 2nd to last byte or timeout
-                if((i2c->rxBufferLength+2) == i2c->reqCount || (chkTimeout && !i2c->timeoutRxNAK))
-                {
-                    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TXAK; // no STOP, Rx, NAK on recv
-                }
-                // if last byte or timeout send STOP
-                if((i2c->rxBufferLength+1) >= i2c->reqCount || (chkTimeout && i2c->timeoutRxNAK))
-                {
-                    i2c->timeoutRxNAK = 0; // clear flag
-                    // change to Tx mode
-                    *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
-                    // grab last data
-                    data = *(i2c->D);
-                    i2c->rxBuffer[i2c->rxBufferLength++] = data;
-                    if(i2c->currentStop == I2C_STOP) // NAK then STOP
-                    {
-                        delayMicroseconds(1); // empirical patch, lets things settle before issuing STOP
-                        *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
-                    }
-                    // else NAK no STOP
 
-                    // Set final status
-                    if(chkTimeout)
-                    {
-                        i2c->currentStatus = I2C_TIMEOUT; // Rx incomplete, mark as timeout
-                        I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
-                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if timeout
-                    }
-                    else
-                    {
-                        i2c->currentStatus = I2C_WAITING; // Rx complete, change to waiting state
-                        if(i2c->user_onReqFromDone != nullptr) i2c->user_onReqFromDone(); // Call Master Rx complete callback
-                    }
-                }
-                else
-                {
-                    // grab next data, not last byte, will ACK
-                    i2c->rxBuffer[i2c->rxBufferLength++] = *(i2c->D);
-                }
-                if(chkTimeout) i2c->timeoutRxNAK = 1; // set flag to indicate NAK sent
-            }
-        }
+// ------------------------------------------------------------------------------------------------------
+// Run Job - queues one run of a periodic job, into back half of Rx buffer, intended for internal use only
+// return: none
+// parameters:
+//      job = job descriptor
+//
+void i2c_t3::runJob_(struct i2cJob* job)
+{
+    struct i2cTransaction* msg = job->msgs;
+    size_t n = 0;
+
+    // skip run if previous still busy
+    if(!done(job->msgs[0]) || !done(job->msgs[1]))
+    {
+        job->overruns++;
+        return;
     }
-    //
-    // ISR/DMA mode - non-blocking
-    //
-    else if(i2c->opMode == I2C_OP_MODE_ISR || i2c->opMode == I2C_OP_MODE_DMA)
+
+    if(job->txLen)
     {
-        // send 1st data and enable interrupts
-        i2c->currentStatus = I2C_SEND_ADDR;
-        i2c->currentStop = sendStop;
-        if(i2c->opMode == I2C_OP_MODE_DMA && i2c->reqCount >= 5) // limit transfers less than 5 bytes to ISR method
-        {
-            // init DMA, let the hack begin
-            i2c->activeDMA = I2C_DMA_ADDR;
-            i2c->DMA->source(*(i2c->D));
-            i2c->DMA->destinationBuffer(&i2c->rxBuffer[0],i2c->reqCount-1); // DMA gets all except last byte
-        }
-        // start ISR
-        *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX; // enable intr
-        *(i2c->D) = (addr << 1) | 1; // address + READ
+        msg[n].addr = job->addr;
+        msg[n].rw = I2C_WRITE;
+        msg[n].data = (uint8_t*)job->txData; // Tx data is only read
+        msg[n].len = job->txLen;
+        n++;
+    }
+    if(job->rxLen)
+    {
+        msg[n].addr = job->addr;
+        msg[n].rw = I2C_READ;
+        msg[n].data = &job->rxBuf[(job->front ^ 1) * job->rxLen];
+        msg[n].len = job->rxLen;
+        n++;
+    }
+    for(size_t idx=0; idx < n; idx++)
+    {
+        msg[idx].onDone = (idx == n-1) ? jobDone_ : nullptr;
+        msg[idx].ctx = job;
+        msg[idx].deadline = micros() + job->period;
+        msg[idx].hasDeadline = 1;
+        msg[idx].priority = 0;
+    }
+    flushWrites_(job->i2c, job->bus, job->addr, &msg[0]);
+    prepChain_(msg, n);
+    appendQueue_(job->i2c, job->bus, &msg[0], &msg[n-1]);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Job Done - done callback of a periodic job run, swaps Rx buffer halves on success, intended for internal
+//            use only
+// return: none
+// parameters:
+//      ctx = job descriptor
+//      status = final status of run
+//
+void i2c_t3::jobDone_(void* ctx, i2c_status status)
+{
+    struct i2cJob* job = (struct i2cJob*)ctx;
+
+    job->status = status;
+    if(status == I2C_WAITING)
+    {
+        if(job->rxLen) job->front ^= 1;
+        if(++job->seq == 0) job->seq = 1; // 0 reserved for no sample
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Start Stream - starts a continuous read alternating between two user buffers, re-armed from the ISR
+// return: 1=started, 0=fail (Slave or IMM mode, zero length or missing buffer, or stream already active)
+// parameters:
+//      stream = stream descriptor, caller sets addr, txData, txLen, buf[0], buf[1], len, onFill, ctx
+//
+uint8_t i2c_t3::startStream_(struct i2cStruct* i2c, uint8_t bus, struct i2cStream* stream)
+{
+    // reads are re-armed from ISR, so ISR/DMA Master only
+    if(i2c->currentMode == I2C_SLAVE || i2c->opMode == I2C_OP_MODE_IMM) return 0;
+    if(stream->len == 0 || stream->buf[0] == nullptr || stream->buf[1] == nullptr) return 0;
+    if(stream->active || !done(stream->msgs[0]) || !done(stream->msgs[1])) return 0;
+
+    // init stream, messages start as done
+    stream->i2c = i2c;
+    stream->bus = bus;
+    stream->fill = 0;
+    stream->full = 0;
+    stream->paused = 0;
+    stream->seq = 0;
+    stream->stalls = 0;
+    stream->status = I2C_WAITING;
+    memset(stream->msgs, 0, sizeof(stream->msgs));
+    stream->active = 1;
+    runStream_(stream);
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Stop Stream - stops a stream.  A read in progress is allowed to complete (this waits for it).
+// return: none
+// parameters:
+//      stream = stream descriptor
+//
+void i2c_t3::stopStream(i2cStream& stream)
+{
+    stream.active = 0;
+    while(!done(stream.msgs[0]) || !done(stream.msgs[1])) wait_(stream.i2c);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Stream Buffer - returns the oldest filled buffer of a stream
+// return: pointer to filled buffer, nullptr=none filled yet
+// parameters:
+//      stream = stream descriptor
+//
+uint8_t* i2c_t3::streamBuffer(const i2cStream& stream)
+{
+    uint8_t full = stream.full;
+
+    if(full == 0) return nullptr;
+    if(full == 3) return stream.buf[stream.fill]; // both filled, next to fill is the older one
+    return stream.buf[full >> 1];
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Release Stream - releases the oldest filled buffer of a stream for refill, and resumes a stalled stream
+// return: none
+// parameters:
+//      stream = stream descriptor
+//
+void i2c_t3::releaseStream(i2cStream& stream)
+{
+    uint32_t primask;
+    uint8_t resume;
+
+    I2C_IRQ_SAVE(primask);
+    if(stream.full == 3)
+        stream.full &= ~(1 << stream.fill);
+    else
+        stream.full = 0;
+    resume = stream.paused && stream.active;
+    stream.paused = 0;
+    I2C_IRQ_RESTORE(primask);
+    if(resume) runStream_(&stream);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Run Stream - queues one read of a stream into the buffer to fill, intended for internal use only
+// return: none
+// parameters:
+//      stream = stream descriptor
+//
+void i2c_t3::runStream_(struct i2cStream* stream)
+{
+    struct i2cTransaction* msg = stream->msgs;
+    size_t n = 0;
+
+    if(stream->txLen)
+    {
+        msg[n].addr = stream->addr;
+        msg[n].rw = I2C_WRITE;
+        msg[n].data = (uint8_t*)stream->txData; // Tx data is only read
+        msg[n].len = stream->txLen;
+        n++;
+    }
+    msg[n].addr = stream->addr;
+    msg[n].rw = I2C_READ;
+    msg[n].data = stream->buf[stream->fill];
+    msg[n].len = stream->len;
+    n++;
+    for(size_t idx=0; idx < n; idx++)
+    {
+        msg[idx].onDone = (idx == n-1) ? streamDone_ : nullptr;
+        msg[idx].ctx = stream;
+        msg[idx].deadline = 0;
+        msg[idx].hasDeadline = 0;
+        msg[idx].priority = 0;
+    }
+    flushWrites_(stream->i2c, stream->bus, stream->addr, &msg[0]);
+    prepChain_(msg, n);
+    appendQueue_(stream->i2c, stream->bus, &msg[0], &msg[n-1]);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Stream Done - done callback of a stream read, marks buffer filled and re-arms the next read into the other
+//               buffer (or stalls if it is still owned by the application), intended for internal use only
+// return: none
+// parameters:
+//      ctx = stream descriptor
+//      status = final status of read
+//
+void i2c_t3::streamDone_(void* ctx, i2c_status status)
+{
+    struct i2cStream* stream = (struct i2cStream*)ctx;
+
+    stream->status = status;
+    if(status == I2C_WAITING)
+    {
+        stream->full |= (1 << stream->fill);
+        stream->fill ^= 1;
+        stream->seq++;
+    }
+    else
+        stream->active = 0; // read error stops stream
+    if(stream->onFill != nullptr) stream->onFill(stream->ctx, status);
+    if(!stream->active) return;
+    if(stream->full & (1 << stream->fill))
+    {
+        stream->paused = 1; // wait for releaseStream()
+        stream->stalls++;
+    }
+    else
+        runStream_(stream);
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Send Bulk - non-blocking routine, starts a Master write or read of bulk.len bytes as one transaction.  Write
+//             data is pulled through the refill callback, and read data is received into the chunk buffer and
+//             handed to the drain callback.  A zero length or incomplete descriptor fails with I2C_BUF_OVF.
+//             Use done() or finish() to determine completion and status() to determine success/fail.
+// return: none
+// parameters:
+//      bulk = bulk descriptor, caller sets addr, rw, len, ctx, and refill (write) or buf, chunk, drain (read)
+//      i2c_stop = I2C_NOSTOP, I2C_STOP
+//      timeout = timeout in microseconds (only used for Immediate operation)
+//      onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+//      ctx = done callback context
+//
+void i2c_t3::sendBulk_(struct i2cStruct* i2c, uint8_t bus, struct i2cBulk* bulk, i2c_stop sendStop, uint32_t timeout,
+                       i2c_done_cb onDone, void* ctx)
+{
+    static const struct i2cSegment empty = {nullptr, 0};
+
+    // fail immediately if zero length or missing callback/buffer.  Status and done callback (run by callDone_)
+    // are only set if no other transfer is active, otherwise this one fails directly.
+    if(bulk->len == 0 || (bulk->rw == I2C_WRITE && bulk->refill == nullptr) ||
+       (bulk->rw == I2C_READ && (bulk->buf == nullptr || bulk->chunk == 0 || bulk->drain == nullptr)))
+    {
+        if(!done_(i2c)) { if(onDone != nullptr) onDone(ctx, I2C_BUF_OVF); return; }
+        i2c->currentStatus=I2C_BUF_OVF; i2c->doneCtx=ctx; i2c->doneCb=onDone;
+        return;
+    }
+    if(bulk->rw == I2C_WRITE)
+    {
+        // start with an empty segment, first byte refills it
+        sendTx_(i2c, bus, bulk->addr, &empty, 1, bulk, sendStop, timeout, onDone, ctx);
+    }
+    else
+    {
+        sendRx_(i2c, bus, bulk->addr, bulk->buf, bulk->len, bulk, sendStop, timeout, onDone, ctx);
     }
 }
 
 
+// ------------------------------------------------------------------------------------------------------
+// Set Slave Queue - sets a Slave Rx message queue on a bus.  Completed Slave Rx messages are copied into the
+//                   queue by the ISR, and read by the application with slaveMessage()/slaveRelease().
+// return: 1=set, 0=fail (missing slots or buffer, zero depth or size)
+// parameters:
+//      queue = queue descriptor, caller sets msgs, buf, depth, size
+//
+uint8_t i2c_t3::setSlaveQueue_(struct i2cStruct* i2c, struct i2cSlaveQueue* queue)
+{
+    if(queue->msgs == nullptr || queue->buf == nullptr || queue->depth == 0 || queue->size == 0) return 0;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->drops = 0;
+    i2c->slaveQueue = queue;
+    return 1;
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Message - returns the oldest message in a Slave Rx queue, owned by the caller until slaveRelease()
+// return: pointer to message, nullptr=queue empty
+// parameters:
+//      queue = queue descriptor
+//
+const i2cSlaveMsg* i2c_t3::slaveMessage(const i2cSlaveQueue& queue)
+{
+    uint32_t tail = queue.tail;
+
+    if(queue.head == tail) return nullptr;
+    return &queue.msgs[tail % queue.depth];
+}
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Release - releases the oldest message in a Slave Rx queue, freeing its slot for the ISR
+// return: none
+// parameters:
+//      queue = queue descriptor
+//
+void i2c_t3::slaveRelease(i2cSlaveQueue& queue)
+{
+    if(queue.head != queue.tail) queue.tail++;
+}
+
+
 // ------------------------------------------------------------------------------------------------------
 // Get Wire Error - returns "Wire" error code from a failed Tx/Rx command
 // return: 0=success, 1=data too long, 2=recv addr NACK, 3=recv data NACK, 4=other error (timeout, arb lost)
@@ -981,25 +3326,37 @@ uint8_t i2c_t3::finish_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout)
 
     // wait for completion or timeout
     deltaT = 0;
-    while(!done_(i2c) && (timeout == 0 || deltaT < timeout));
+    while(!done_(i2c) && (timeout == 0 || deltaT < timeout)) wait_(i2c, &i2c->currentStatus);
 
     // DMA mode and timeout
     if(timeout != 0 && deltaT >= timeout && i2c->opMode == I2C_OP_MODE_DMA && i2c->activeDMA != I2C_DMA_OFF)
     {
-        // If DMA mode times out, then wait for transfer to end then mark it as timeout.
-        // This is done this way because abruptly ending the DMA seems to cause
-        // the I2C_S_BUSY flag to get stuck, and I cannot find a reliable way to clear it.
-        while(!done_(i2c));
-        i2c->currentStatus = I2C_TIMEOUT;
+        // If DMA mode times out, abort the DMA and recover the bus.  Abruptly ending the DMA can leave
+        // the I2C_S_BUSY flag stuck (or a Slave may be holding the bus), so this is bounded and resets the
+        // module and bus lines if needed.
+        dmaAbort_(i2c, bus);
     }
 
-    // check exit status, if not done then timeout occurred
+    // check exit status, if not done then timeout occurred (cancel pending retry first)
+    cancelPending_(i2c);
+    if(i2c->DMA != nullptr) dmaReturn_(i2c);
     if(!done_(i2c)) i2c->currentStatus = I2C_TIMEOUT; // set to timeout state
 
-    // delay to allow bus to settle - allow Timeout or STOP to complete and be recognized.  Timeouts must
-    //                                propagate through ISR, and STOP must be recognized on both
-    //                                Master and Slave sides
-    delayMicroseconds(4);
+    // allow bus to settle - on success wait for STOP to complete (bus released, bounded to 2 bit periods)
+    //                      then bus free time, both scaled to rate.  No STOP was sent if still Master
+    //                      (I2C_NOSTOP).  On failure use fixed delay, as Timeouts must propagate through ISR,
+    //                      and STOP must be recognized on both Master and Slave sides
+    if(i2c->currentStatus == I2C_WAITING)
+    {
+        if(!(*(i2c->C1) & I2C_C1_MST))
+        {
+            elapsedMicros stopT;
+            while((*(i2c->S) & I2C_S_BUSY) && stopT < i2c->stopWait);
+            if(i2c->busFreeTime) delayMicroseconds(i2c->busFreeTime);
+        }
+    }
+    else
+        delayMicroseconds(4);
 
     // note that onTransmitDone, onReqFromDone, onError callbacks are handled in ISR, this is done
     // because use of this function is optional on background transfers
@@ -1016,7 +3373,7 @@ uint8_t i2c_t3::finish_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout)
 //
 size_t i2c_t3::write(uint8_t data)
 {
-    if(i2c->txBufferLength < I2C_TX_BUFFER_LENGTH)
+    if(i2c->txBufferLength < i2c->txBufferSize)
     {
         i2c->txBuffer[i2c->txBufferLength++] = data;
         return 1;
@@ -1035,9 +3392,9 @@ size_t i2c_t3::write(uint8_t data)
 //
 size_t i2c_t3::write(const uint8_t* data, size_t count)
 {
-    if(i2c->txBufferLength < I2C_TX_BUFFER_LENGTH)
+    if(i2c->txBufferLength < i2c->txBufferSize)
     {
-        size_t avail = I2C_TX_BUFFER_LENGTH - i2c->txBufferLength;
+        size_t avail = i2c->txBufferSize - i2c->txBufferLength;
         uint8_t* dest = i2c->txBuffer + i2c->txBufferLength;
 
         if(count > avail)
@@ -1164,8 +3521,25 @@ void i2c0_isr(void) // I2C0 ISR
 //
 void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
 {
-    uint8_t status, c1, data;
     i2c_t3::isrActive++;
+    i2c_t3::isrTransfer_(i2c, bus); // run transfer state machine
+    if(i2c->DMA != nullptr && i2c->activeDMA == I2C_DMA_OFF) i2c_t3::dmaReturn_(i2c); // return DMA channel to pool
+    if(i2c->acqWait && !(*(i2c->S) & I2C_S_BUSY)) // bus freed (STOP detect), issue deferred START
+    {
+        i2c->acqWait = 0;
+        i2c_t3::restart_(i2c);
+    }
+    if(i2c->txn == nullptr) i2c_t3::callDone_(i2c); // run done callback of completed background Tx/Rx
+    i2c_t3::serviceQueue_(i2c, bus); // retire completed transaction, start next queued transaction
+    i2c_t3::isrActive--;
+}
+
+//
+// I2C ISR transfer state machine
+//
+void i2c_t3::isrTransfer_(struct i2cStruct* i2c, uint8_t bus)
+{
+    uint8_t status, c1, data;
 
     status = *(i2c->S);
     c1 = *(i2c->C1);
@@ -1173,6 +3547,13 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
         uint8_t flt = *(i2c->FLT);  // store flags
     #endif
 
+    if(i2c->activeDMA == I2C_DMA_CHAIN)
+    {
+        // Chained DMA frame, C1 written by DMA at end of frame
+        chainDone_(i2c, status);
+        return;
+    }
+
     if(c1 & I2C_C1_MST)
     {
         //
@@ -1182,7 +3563,15 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
         {
             if(i2c->activeDMA == I2C_DMA_BULK || i2c->activeDMA == I2C_DMA_LAST)
             {
-                if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK)
+                if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK && i2c->txDmaLeft)
+                {
+                    // segment boundary, re-arm DMA with next chunk (I2C DMA request stays pending until serviced)
+                    i2c->DMA->clearInterrupt();
+                    i2c->DMA->clearComplete();
+                    txDmaChunk_(i2c);
+                    if(i2c->currentStatus == I2C_SENDING) i2c->DMA->enable(); // not aborted by bulk write underrun
+                }
+                else if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK)
                 {
                     // clear DMA interrupt, final byte should trigger another ISR
                     i2c->DMA->clearInterrupt();
@@ -1200,8 +3589,9 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     i2c->DMA->clearComplete();
                     // re-engage ISR for last byte
                     i2c->activeDMA = I2C_DMA_OFF;
-                    i2c->txBufferIndex = i2c->txBufferLength-1;
-                    *(i2c->D) = i2c->txBuffer[i2c->txBufferIndex];
+                    i2c->txBufferIndex = i2c->txLength-1;
+                    data = txNext_(i2c);
+                    if(i2c->currentStatus == I2C_SENDING) *(i2c->D) = data; // not aborted by bulk write underrun
                     *(i2c->S) = I2C_S_IICIF; // clear intr
                 }
                 else if(i2c->DMA->error())
@@ -1223,9 +3613,9 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     }
                     *(i2c->C1) = I2C_C1_IICEN; // change to Rx mode, intr disabled, DMA disabled
                     *(i2c->S) = I2C_S_IICIF; // clear intr
-                    if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if DMA error or ARBL
+                    if(!retryCheck_(i2c, I2C_SENDING) && i2c->user_onError != nullptr)
+                        i2c->user_onError(); // run Error callback if DMA error or ARBL (and not retrying)
                 }
-                i2c_t3::isrActive--;
                 return;
             } // end DMA Tx
             else
@@ -1246,7 +3636,8 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                         // TODO does this need to check IAAS and drop to Slave Rx? if so set Rx + dummy read.
                         *(i2c->S) = I2C_S_IICIF; // clear intr
                         I2C_ERR_INC(I2C_ERRCNT_ARBL);
-                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if ARBL
+                        if(!retryCheck_(i2c, I2C_SENDING) && i2c->user_onError != nullptr)
+                            i2c->user_onError(); // run Error callback if ARBL (and not retrying)
                     }
                     // check if slave ACK'd
                     else if(status & I2C_S_RXAK)
@@ -1266,12 +3657,13 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                         // note: Slave NAK is an error, so send STOP regardless of setting
                         *(i2c->C1) = I2C_C1_IICEN;
                         *(i2c->S) = I2C_S_IICIF; // clear intr
-                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if NAK
+                        if(!retryCheck_(i2c, I2C_SENDING) && i2c->user_onError != nullptr)
+                            i2c->user_onError(); // run Error callback if NAK (and not retrying)
                     }
                     else
                     {
                         // check if last byte transmitted
-                        if(++i2c->txBufferIndex >= i2c->txBufferLength)
+                        if(++i2c->txBufferIndex >= i2c->txLength)
                         {
                             // Tx complete, change to waiting state
                             i2c->currentStatus = I2C_WAITING;
@@ -1287,20 +3679,33 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                         else if(i2c->activeDMA == I2C_DMA_ADDR)
                         {
                             // Start DMA
-                            i2c->activeDMA = I2C_DMA_BULK;
-                            *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX | I2C_C1_DMAEN; // intr en, Tx mode, DMA en
+                            data = txNext_(i2c);
+                            if(i2c->currentStatus != I2C_SENDING) return; // bulk write underrun, aborted
+                            if(chainLoad_(i2c))
+                            {
+                                // chained DMA, rest of frame runs without I2C intr
+                                i2c->activeDMA = I2C_DMA_CHAIN;
+                                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX | I2C_C1_DMAEN; // intr dis, Tx mode, DMA en
+                            }
+                            else
+                            {
+                                txDmaChunk_(i2c);
+                                if(i2c->currentStatus != I2C_SENDING) return; // bulk write underrun, aborted
+                                i2c->activeDMA = I2C_DMA_BULK;
+                                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TX | I2C_C1_DMAEN; // intr en, Tx mode, DMA en
+                            }
                             i2c->DMA->enable();
-                            *(i2c->D) = i2c->txBuffer[1]; // DMA will start on next request
+                            *(i2c->D) = data; // DMA will start on next request
                             *(i2c->S) = I2C_S_IICIF; // clear intr
                         }
                         else
                         {
                             // ISR transmit next byte
-                            *(i2c->D) = i2c->txBuffer[i2c->txBufferIndex];
+                            data = txNext_(i2c);
+                            if(i2c->currentStatus == I2C_SENDING) *(i2c->D) = data; // not aborted by bulk write underrun
                             *(i2c->S) = I2C_S_IICIF; // clear intr
                         }
                     }
-                    i2c_t3::isrActive--;
                     return;
                 }
                 else if(i2c->currentStatus == I2C_SEND_ADDR)
@@ -1309,24 +3714,28 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     if(status & I2C_S_ARBL)
                     {
                         // Arbitration Lost
+                        i2c->activeDMA = I2C_DMA_OFF; // clear pending DMA
                         i2c->currentStatus = I2C_ARB_LOST;
                         *(i2c->S) = I2C_S_ARBL; // clear arbl flag
                         *(i2c->C1) = I2C_C1_IICEN; // change to Rx mode, intr disabled (does this send STOP if ARBL flagged?)
                         // TODO does this need to check IAAS and drop to Slave Rx? if so set Rx + dummy read. not sure if this would work for DMA
                         *(i2c->S) = I2C_S_IICIF; // clear intr
                         I2C_ERR_INC(I2C_ERRCNT_ARBL);
-                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if ARBL
+                        if(!retryCheck_(i2c, I2C_SEND_ADDR) && i2c->user_onError != nullptr)
+                            i2c->user_onError(); // run Error callback if ARBL (and not retrying)
                     }
                     else if(status & I2C_S_RXAK)
                     {
                         // Slave addr NAK
+                        i2c->activeDMA = I2C_DMA_OFF; // clear pending DMA
                         i2c->currentStatus = I2C_ADDR_NAK; // NAK on Addr
                         // send STOP, change to Rx mode, intr disabled
                         // note: Slave NAK is an error, so send STOP regardless of setting
                         *(i2c->C1) = I2C_C1_IICEN;
                         *(i2c->S) = I2C_S_IICIF; // clear intr
                         I2C_ERR_INC(I2C_ERRCNT_ADDR_NAK);
-                        if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if NAK
+                        if(!retryCheck_(i2c, I2C_SEND_ADDR) && i2c->user_onError != nullptr)
+                            i2c->user_onError(); // run Error callback if NAK (and not retrying)
                     }
                     else if(i2c->activeDMA == I2C_DMA_ADDR)
                     {
@@ -1348,11 +3757,11 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                         data = *(i2c->D); // dummy read
                         *(i2c->S) = I2C_S_IICIF; // clear intr
                     }
-                    i2c_t3::isrActive--;
                     return;
                 }
                 else if(i2c->currentStatus == I2C_TIMEOUT)
                 {
+                    i2c->activeDMA = I2C_DMA_OFF; // clear pending DMA (if happens on address byte)
                     // send STOP if configured
                     if(i2c->currentStop == I2C_STOP)
                         *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
@@ -1361,7 +3770,6 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     *(i2c->S) = I2C_S_IICIF; // clear intr
                     I2C_ERR_INC(I2C_ERRCNT_TIMEOUT);
                     if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if timeout
-                    i2c_t3::isrActive--;
                     return;
                 }
                 else
@@ -1370,7 +3778,6 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     // send STOP, change to Rx mode, intr disabled
                     *(i2c->C1) = I2C_C1_IICEN;
                     *(i2c->S) = I2C_S_IICIF; // clear intr
-                    i2c_t3::isrActive--;
                     return;
                 }
             } // end ISR Tx
@@ -1381,7 +3788,20 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
             //
             if(i2c->activeDMA == I2C_DMA_BULK || i2c->activeDMA == I2C_DMA_LAST)
             {
-                if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK) // 2nd to last byte
+                if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK && i2c->rxCount + i2c->rxDmaLen < i2c->reqCount-1)
+                {
+                    // bulk read chunk done, drain it and re-arm DMA with next chunk (next byte waits for D read)
+                    i2c->DMA->clearInterrupt();
+                    i2c->DMA->clearComplete();
+                    i2c->rxCount += i2c->rxDmaLen;
+                    rxDrain_(i2c);
+                    i2c->rxDmaLen = i2c->reqCount-1 - i2c->rxCount;
+                    if(i2c->rxDmaLen > i2c->bulk->chunk) i2c->rxDmaLen = i2c->bulk->chunk;
+                    i2c->DMA->destinationBuffer(i2c->rxPtr, i2c->rxDmaLen);
+                    i2c->DMA->enable();
+                    *(i2c->S) = I2C_S_IICIF; // clear intr
+                }
+                else if(i2c->DMA->complete() && i2c->activeDMA == I2C_DMA_BULK) // 2nd to last byte
                 {
                     // clear DMA interrupt, final byte should trigger another ISR
                     i2c->DMA->clearInterrupt();
@@ -1397,11 +3817,12 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     // change to Tx mode
                     *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
                     // grab last data
-                    i2c->rxBufferLength = i2c->reqCount-1;
-                    i2c->rxBuffer[i2c->rxBufferLength++] = *(i2c->D);
+                    i2c->rxCount = i2c->reqCount-1;
+                    rxStore_(i2c, *(i2c->D), 1);
+                    if(i2c->rxPtr == i2c->rxBuffer) i2c->rxBufferLength = i2c->rxCount; // Rx buffer data now readable
                     if(i2c->currentStop == I2C_STOP) // NAK then STOP
                     {
-                        delayMicroseconds(1); // empirical patch, lets things settle before issuing STOP
+                        if(i2c->stopSettle) delayMicroseconds(i2c->stopSettle); // empirical patch, lets things settle before issuing STOP (not needed at 1MHz+)
                         *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
                     }
                     // else NAK no STOP
@@ -1418,29 +3839,30 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     *(i2c->C1) = I2C_C1_IICEN; // change to Rx mode, intr disabled, DMA disabled
                     *(i2c->S) = I2C_S_IICIF; // clear intr
                     I2C_ERR_INC(I2C_ERRCNT_DMA_ERR);
-                    if(i2c->user_onError != nullptr) i2c->user_onError(); // run Error callback if DMA error
+                    if(!retryCheck_(i2c, I2C_SEND_ADDR) && i2c->user_onError != nullptr)
+                        i2c->user_onError(); // run Error callback if DMA error (and not retrying)
                 }
-                i2c_t3::isrActive--;
                 return;
             }
             else
             {
                 // check if 2nd to last byte or timeout
-                if((i2c->rxBufferLength+2) == i2c->reqCount || (i2c->currentStatus == I2C_TIMEOUT && !i2c->timeoutRxNAK))
+                if((i2c->rxCount+2) == i2c->reqCount || (i2c->currentStatus == I2C_TIMEOUT && !i2c->timeoutRxNAK))
                 {
                     *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_MST | I2C_C1_TXAK; // no STOP, Rx, NAK on recv
                 }
                 // if last byte or timeout send STOP
-                if((i2c->rxBufferLength+1) >= i2c->reqCount || (i2c->currentStatus == I2C_TIMEOUT && i2c->timeoutRxNAK))
+                if((i2c->rxCount+1) >= i2c->reqCount || (i2c->currentStatus == I2C_TIMEOUT && i2c->timeoutRxNAK))
                 {
                     i2c->timeoutRxNAK = 0; // clear flag
                     // change to Tx mode
                     *(i2c->C1) = I2C_C1_IICEN | I2C_C1_MST | I2C_C1_TX;
                     // grab last data
-                    i2c->rxBuffer[i2c->rxBufferLength++] = *(i2c->D);
+                    rxStore_(i2c, *(i2c->D), 1);
+                    if(i2c->rxPtr == i2c->rxBuffer) i2c->rxBufferLength = i2c->rxCount; // Rx buffer data now readable
                     if(i2c->currentStop == I2C_STOP) // NAK then STOP
                     {
-                        delayMicroseconds(1); // empirical patch, lets things settle before issuing STOP
+                        if(i2c->stopSettle) delayMicroseconds(i2c->stopSettle); // empirical patch, lets things settle before issuing STOP (not needed at 1MHz+)
                         *(i2c->C1) = I2C_C1_IICEN; // send STOP, change to Rx mode, intr disabled
                     }
                     // else NAK no STOP
@@ -1460,13 +3882,12 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                 else
                 {
                     // grab next data, not last byte, will ACK
-                    i2c->rxBuffer[i2c->rxBufferLength++] = *(i2c->D);
+                    rxStore_(i2c, *(i2c->D), 0);
                     *(i2c->S) = I2C_S_IICIF; // clear intr
                 }
                 if(i2c->currentStatus == I2C_TIMEOUT && !i2c->timeoutRxNAK)
                     i2c->timeoutRxNAK = 1; // set flag to indicate NAK sent
 
-                i2c_t3::isrActive--;
                 return;
             }
         }
@@ -1477,6 +3898,17 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
         // Slave Mode
         //
 
+        #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+            if(i2c->activeDMA == I2C_DMA_BULK && i2c->DMA->complete())
+            {
+                // Slave Rx DMA filled Rx buffer, further bytes handled (discarded) by ISR.  Any pending I2C
+                // flags are left set and handled on next ISR entry
+                slaveRxDmaStop_(i2c);
+                *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE;
+                return;
+            }
+        #endif
+
         // ARBL makes no sense on Slave, but this might get set if there is a pullup problem and
         // SCL/SDA get stuck.  This is primarily to guard against ARBL flag getting stuck.
         if(status & I2C_S_ARBL)
@@ -1489,17 +3921,21 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
                 #endif
                 *(i2c->S) = I2C_S_IICIF; // clear intr
-                i2c_t3::isrActive--;
                 return;
             }
         }
         if(status & I2C_S_IAAS)
         {
             // If in Slave Rx already, then RepSTART occured, run callback
-            if(i2c->currentStatus == I2C_SLAVE_RX && i2c->user_onReceive != nullptr)
+            slaveRxDmaStop_(i2c);
+            if(i2c->currentStatus == I2C_SLAVE_RX)
             {
-                i2c->rxBufferIndex = 0;
-                i2c->user_onReceive(i2c->rxBufferLength);
+                slaveRxDone_(i2c);
+                if(i2c->user_onReceive != nullptr)
+                {
+                    i2c->rxBufferIndex = 0;
+                    i2c->user_onReceive(i2c->rxBufferLength);
+                }
             }
 
             // Is Addressed As Slave
@@ -1534,12 +3970,23 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                 i2c->rxBufferLength = 0;
                 *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE;
                 i2c->rxAddr = (*(i2c->D) >> 1); // read to get target addr
+                #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
+                    if(i2c->opMode == I2C_OP_MODE_DMA && dmaBorrow_(i2c))
+                    {
+                        // DMA receives payload, ISR only sees RepSTART/STOP (addr read above, so DMA starts
+                        // on next data byte)
+                        i2c->DMA->source(*(i2c->D));
+                        i2c->DMA->destinationBuffer(i2c->rxBuffer, i2c->rxBufferSize);
+                        i2c->activeDMA = I2C_DMA_BULK;
+                        i2c->DMA->enable();
+                        *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE | I2C_C1_DMAEN; // intr en, Rx mode, DMA en
+                    }
+                #endif
             }
             #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
                 *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
             #endif
             *(i2c->S) = I2C_S_IICIF; // clear intr
-            i2c_t3::isrActive--;
             return;
         }
         if(c1 & I2C_C1_TX)
@@ -1573,15 +4020,20 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                     // be cleared in order to work
                     *(i2c->FLT) |= I2C_FLT_STOPF | I2C_FLT_STARTF;  // clear STOP/START intr
                     *(i2c->FLT) &= ~I2C_FLT_SSIE;                   // disable STOP/START intr (will re-enable on next IAAS)
+                    if(i2c->activeDMA == I2C_DMA_BULK)
+                    {
+                        slaveRxDmaStop_(i2c);
+                        *(i2c->C1) = I2C_C1_IICEN | I2C_C1_IICIE; // DMA disabled
+                    }
                     *(i2c->S) = I2C_S_IICIF; // clear intr
                     i2c->currentStatus = I2C_WAITING;
-                    // Slave Rx complete, run callback
+                    // Slave Rx complete, queue message and run callback
+                    slaveRxDone_(i2c);
                     if(i2c->user_onReceive != nullptr)
                     {
                         i2c->rxBufferIndex = 0;
                         i2c->user_onReceive(i2c->rxBufferLength);
                     }
-                    i2c_t3::isrActive--;
                     return;
                 }
             #endif
@@ -1596,7 +4048,7 @@ void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus)
                 attachInterrupt(i2c->currentSDA, i2c_t3::sda0_rising_isr, RISING);
             #endif
             data = *(i2c->D);
-            if(i2c->rxBufferLength < I2C_RX_BUFFER_LENGTH)
+            if(i2c->rxBufferLength < i2c->rxBufferSize)
                 i2c->rxBuffer[i2c->rxBufferLength++] = data;
         }
         #if defined(__MKL26Z64__) || defined(__MK64FX512__) || defined(__MK66FX1M0__) // LC/3.5/3.6
@@ -1637,6 +4089,7 @@ void i2c_t3::sda_rising_isr_handler(struct i2cStruct* i2c, uint8_t bus)
     {
         i2c->currentStatus = I2C_WAITING;
         detachInterrupt(i2c->currentSDA);
+        slaveRxDone_(i2c);
         if(i2c->user_onReceive != nullptr)
         {
             i2c->rxBufferIndex = 0;
@@ -37,6 +37,10 @@
 #include <stdio.h> // for size_t
 #include "Arduino.h"
 #include <DMAChannel.h>
+#include <IntervalTimer.h>
+#if defined(__cpp_impl_coroutine)
+    #include <coroutine>
+#endif
 
 // TODO missing kinetis.h defs
 #ifndef I2C_F_DIV52
@@ -82,6 +86,19 @@
 #define I2C_TX_BUFFER_LENGTH 259
 #define I2C_RX_BUFFER_LENGTH 259
 
+// ------------------------------------------------------------------------------------------------------
+// Per-bus Tx/Rx buffer sizes - uncomment and set below to size the buffers of a single bus (eg. a bus which
+//                              only talks to a small sensor).  Buses not set here use the sizes above.
+//
+//#define I2C0_TX_BUFFER_LENGTH 259
+//#define I2C0_RX_BUFFER_LENGTH 259
+//#define I2C1_TX_BUFFER_LENGTH 8
+//#define I2C1_RX_BUFFER_LENGTH 8
+//#define I2C2_TX_BUFFER_LENGTH 8
+//#define I2C2_RX_BUFFER_LENGTH 8
+//#define I2C3_TX_BUFFER_LENGTH 8
+//#define I2C3_RX_BUFFER_LENGTH 8
+
 // ------------------------------------------------------------------------------------------------------
 // Interrupt flag - uncomment and set below to make the specified pin high whenever the
 //                  I2C interrupt occurs (modify pin number as needed).  This is useful as a
@@ -108,7 +125,7 @@
 //                  zeroed using the getErrorCount() and zeroErrorCount() functions respectively.
 //                  When included, errors will be tracked on the following (Master-mode only):
 //                  Reset Bus (auto-retry only), Timeout, Addr NAK, Data NAK, Arb Lost, Bus Not Acquired,
-//                  DMA Errors
+//                  DMA Errors, Deadline Misses (scheduled transactions only)
 //
 #define I2C_ERROR_COUNTERS
 
@@ -122,6 +139,61 @@
 //
 //#define I2C_DISABLE_PRIORITY_CHECK
 
+// ------------------------------------------------------------------------------------------------------
+// Periodic job tick - minimum tick period (in microseconds) of the timer which runs periodic jobs.  The
+//                     timer runs at the greatest common divisor of all job periods, limited to this minimum.
+//                     Job periods which are not a multiple of the tick are rounded to the nearest tick.
+//
+#define I2C_JOB_MIN_TICK 50
+
+// ------------------------------------------------------------------------------------------------------
+// Schedule bypass limit - number of times a queued transaction can be passed by transactions queued after it
+//                         (eg. deadline transactions passing best-effort ones).  Once reached, later
+//                         transactions queue behind it, so best-effort traffic cannot be starved.
+//
+#define I2C_SCHED_MAX_BYPASS 8
+
+// ------------------------------------------------------------------------------------------------------
+// Write coalescing - number of targets per bus which can hold pending register writes (minimum 1), and
+//                    the max number of data bytes held per target.  Contiguous register writes to the same
+//                    target are merged into a single auto-increment burst.  Memory used per bus is
+//                    approximately I2C_COALESCE_SLOTS*(I2C_COALESCE_LENGTH+64) bytes.
+//
+#define I2C_COALESCE_SLOTS 2
+#define I2C_COALESCE_LENGTH 16
+
+// ------------------------------------------------------------------------------------------------------
+// Retry policies - number of per-address retry policies per bus (refer to setRetryPolicy()), and the tick
+//                  period (in microseconds) of the timer which restarts transfers after their backoff.
+//                  Backoff times are rounded up to the tick.
+//
+#define I2C_RETRY_POLICIES 4
+#define I2C_RETRY_TICK 100
+
+// ------------------------------------------------------------------------------------------------------
+// DMA threshold - default minimum transfer length (in bytes, Tx length includes the address byte) which uses
+//                 DMA in DMA mode, shorter transfers use the ISR method.  This can be changed per bus at runtime
+//                 using setDMAThreshold() or calibrateDMA().  Minimum is 5.
+//
+#define I2C_DMA_THRESHOLD 5
+
+// ------------------------------------------------------------------------------------------------------
+// DMA chain descriptors - number of linked DMA descriptors per bus used by chained DMA frames (3.5/3.6 only,
+//                         refer to setDMAChain()).  One is used for the end of frame, the rest for Tx segments,
+//                         transmits with more segments use normal DMA.  Each descriptor uses 32 bytes, reserved
+//                         statically per bus (no heap use), and is constructed when chaining is first enabled.
+//
+#define I2C_DMA_CHAIN_TCDS 4
+
+// ------------------------------------------------------------------------------------------------------
+// DMA channel pool - number of DMA channels shared by all buses in DMA mode.  Channel objects are reserved
+//                    statically (no heap use), and DMA channels are allocated when the first bus enters DMA
+//                    mode, and released when the last bus leaves it.  A bus borrows a channel only for the
+//                    duration of a DMA transfer.  If none is free, or another bus sharing the same DMAMUX
+//                    source holds one (3.6: I2C0/I2C3 and I2C1/I2C2), the transfer uses the ISR method.
+//
+#define I2C_DMA_POOL 2
+
 
 // ======================================================================================================
 // == End User Define Section ===========================================================================
@@ -144,6 +216,35 @@
 #endif
 
 
+// ------------------------------------------------------------------------------------------------------
+// Set per-bus buffer sizes
+//
+#if !defined(I2C0_TX_BUFFER_LENGTH)
+    #define I2C0_TX_BUFFER_LENGTH I2C_TX_BUFFER_LENGTH
+#endif
+#if !defined(I2C0_RX_BUFFER_LENGTH)
+    #define I2C0_RX_BUFFER_LENGTH I2C_RX_BUFFER_LENGTH
+#endif
+#if !defined(I2C1_TX_BUFFER_LENGTH)
+    #define I2C1_TX_BUFFER_LENGTH I2C_TX_BUFFER_LENGTH
+#endif
+#if !defined(I2C1_RX_BUFFER_LENGTH)
+    #define I2C1_RX_BUFFER_LENGTH I2C_RX_BUFFER_LENGTH
+#endif
+#if !defined(I2C2_TX_BUFFER_LENGTH)
+    #define I2C2_TX_BUFFER_LENGTH I2C_TX_BUFFER_LENGTH
+#endif
+#if !defined(I2C2_RX_BUFFER_LENGTH)
+    #define I2C2_RX_BUFFER_LENGTH I2C_RX_BUFFER_LENGTH
+#endif
+#if !defined(I2C3_TX_BUFFER_LENGTH)
+    #define I2C3_TX_BUFFER_LENGTH I2C_TX_BUFFER_LENGTH
+#endif
+#if !defined(I2C3_RX_BUFFER_LENGTH)
+    #define I2C3_RX_BUFFER_LENGTH I2C_RX_BUFFER_LENGTH
+#endif
+
+
 // ------------------------------------------------------------------------------------------------------
 // Interrupt flag setup
 //
@@ -239,6 +340,7 @@ enum i2c_rate     {I2C_RATE_100  = 100000,
                    I2C_RATE_2800 = 2800000,
                    I2C_RATE_3000 = 3000000};
 enum i2c_stop     {I2C_NOSTOP, I2C_STOP};
+enum i2c_rw       {I2C_WRITE, I2C_READ};
 enum i2c_status   {I2C_WAITING,     // stopped states
                    I2C_TIMEOUT,     //  |
                    I2C_ADDR_NAK,    //  |
@@ -252,10 +354,19 @@ enum i2c_status   {I2C_WAITING,     // stopped states
                    I2C_RECEIVING,   //  |
                    I2C_SLAVE_TX,    //  |
                    I2C_SLAVE_RX};   //  V
+enum i2c_backoff  {I2C_BACKOFF_FIXED, I2C_BACKOFF_EXP};
+enum i2c_wait     {I2C_WAIT_SPIN, I2C_WAIT_YIELD, I2C_WAIT_WFI, I2C_WAIT_USER};
+enum i2c_acquire  {I2C_ACQUIRE_POLL, I2C_ACQUIRE_DEFER};
+enum i2c_retry_on {I2C_RETRY_ADDR_NAK = (1 << I2C_ADDR_NAK),
+                   I2C_RETRY_DATA_NAK = (1 << I2C_DATA_NAK),
+                   I2C_RETRY_ARB_LOST = (1 << I2C_ARB_LOST),
+                   I2C_RETRY_DMA_ERR  = (1 << I2C_DMA_ERR),
+                   I2C_RETRY_ALL = (I2C_RETRY_ADDR_NAK | I2C_RETRY_DATA_NAK | I2C_RETRY_ARB_LOST | I2C_RETRY_DMA_ERR)};
 enum i2c_dma_state {I2C_DMA_OFF,
                     I2C_DMA_ADDR,
                     I2C_DMA_BULK,
-                    I2C_DMA_LAST};
+                    I2C_DMA_LAST,
+                    I2C_DMA_CHAIN};
 #if defined(__MKL26Z64__) // LC
     enum i2c_pins {I2C_PINS_16_17 = 0,      // 16 SCL0  17 SDA0
                    I2C_PINS_18_19,          // 19 SCL0  18 SDA0
@@ -331,7 +442,8 @@ enum i2c_err_count {I2C_ERRCNT_RESET_BUS=0,
                     I2C_ERRCNT_DATA_NAK,
                     I2C_ERRCNT_ARBL,
                     I2C_ERRCNT_NOT_ACQ,
-                    I2C_ERRCNT_DMA_ERR};
+                    I2C_ERRCNT_DMA_ERR,
+                    I2C_ERRCNT_DEADLINE};
 
 
 // ------------------------------------------------------------------------------------------------------
@@ -361,7 +473,295 @@ const uint8_t i2c_div_ratio[] =
 
 
 // ------------------------------------------------------------------------------------------------------
-// Main I2C data structure
+// Interrupt masking - used to protect data shared between foreground and ISR (nesting safe)
+//
+#define I2C_IRQ_SAVE(primask)    do {__asm__ volatile("mrs %0, primask\n" : "=r" (primask)); __disable_irq();} while(0)
+#define I2C_IRQ_RESTORE(primask) do {if(!(primask)) __enable_irq();} while(0)
+
+
+// ------------------------------------------------------------------------------------------------------
+// Completion callback - per-transfer handler, called with user context pointer and final transfer status
+//
+typedef void (*i2c_done_cb)(void* ctx, i2c_status status);
+
+// ------------------------------------------------------------------------------------------------------
+// Bulk callbacks - refill supplies the next piece of a bulk write (sets data, returns its length, 0=underrun),
+//                  drain takes the next piece of a bulk read.  Both are called with the user context pointer.
+//
+typedef size_t (*i2c_refill_cb)(void* ctx, const uint8_t** data);
+typedef void (*i2c_drain_cb)(void* ctx, const uint8_t* data, size_t len);
+
+
+// ------------------------------------------------------------------------------------------------------
+// Tx segment - one contiguous piece of a scatter-gather Master transmit.  Segment data is owned by the
+//              caller, and must remain valid until the transmit is done.
+//
+struct i2cSegment
+{
+    const uint8_t* data;                     // Segment data                      (User)
+    size_t len;                              // Segment length                    (User)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Transaction descriptor - used for queued Master transfers.  The descriptor and its data buffer are
+//                          owned by the caller, and must remain valid until the transaction is done.
+//
+struct i2cTransaction
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    i2c_rw   rw;                             // Direction, I2C_WRITE or I2C_READ  (User)
+    uint8_t* data;                           // Tx source or Rx destination       (User)
+    size_t   len;                            // Data length                       (User)
+    i2c_done_cb onDone;                      // Completion callback (optional)    (User)
+    void*    ctx;                            // Completion callback context       (User)
+    uint32_t deadline;                       // Absolute deadline, micros()       (User)
+    uint8_t  hasDeadline;                    // Deadline set flag                 (User)
+    uint8_t  priority;                       // Priority, higher runs first       (User)
+    uint8_t  bypassed;                       // Times passed by later transactions (ISR)
+    i2c_stop stop;                           // STOP or RepSTART at end           (User&ISR)
+    volatile i2c_status status;              // Transaction status                (User&ISR)
+    volatile size_t count;                   // Bytes transferred                 (ISR)
+    volatile uint32_t tStart;                // Start time, micros()              (ISR)
+    volatile uint32_t tDone;                 // Done time, micros()               (ISR)
+    struct i2cTransaction* volatile next;    // Queue link                        (User&ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Transfer handle - future for a background write, read, or write-then-read started with a handle (refer to
+//                   sendTransmission(handle,...), sendRequest(handle,...), sendTransfer()).  It holds the result
+//                   of its own transfer, so several outstanding transfers can be tracked independently of the
+//                   shared bus status.  The handle and data buffers must remain valid until done.
+//
+struct i2cHandle
+{
+    struct i2cTransaction msgs[2] = {};      // Messages (write and/or read)      (Internal)
+    uint8_t  n = 0;                          // Number of messages, 0=not started (Internal)
+    struct i2cStruct* i2c = nullptr;         // Bus data                          (Internal)
+    //
+    // Done Check - returns 1 if transfer is complete (with or without errors), 0 if queued or running
+    //
+    inline uint8_t done(void) const { return (msgs[n ? n-1 : 0].status < I2C_SENDING); }
+    //
+    // Status - returns final status (status of first failed message, or I2C_WAITING on success), an active
+    //          status if not done, or I2C_NOT_ACQ if not started
+    //
+    inline i2c_status status(void) const
+    {
+        if(n == 0) return I2C_NOT_ACQ;
+        for(uint8_t idx=0; idx < n; idx++) if(msgs[idx].status != I2C_WAITING) return msgs[idx].status;
+        return I2C_WAITING;
+    }
+    //
+    // Count - returns #bytes transferred by the last message (bytes read for a read or write-then-read,
+    //         bytes written for a write)
+    //
+    inline size_t count(void) const { return msgs[n ? n-1 : 0].count; }
+    //
+    // Done Time - returns completion timestamp, micros()
+    //
+    inline uint32_t doneTime(void) const { return msgs[n ? n-1 : 0].tDone; }
+    //
+    // Wait - blocking routine with timeout, waits for transfer to complete.  On timeout the transfer is
+    //        terminated (marked I2C_TIMEOUT).
+    // return: 1=success, 0=fail (NAK, timeout, bus error, or not started)
+    // parameters:
+    //     ^timeout = timeout in microseconds (default 0 = infinite wait)
+    //
+    uint8_t wait(uint32_t timeout=0);
+};
+
+
+#if defined(__cpp_impl_coroutine)
+// ------------------------------------------------------------------------------------------------------
+// Transfer awaitable - C++20 co_await-able write, read, or write-then-read (refer to writeAsync(), readAsync(),
+//                      transferAsync()).  The transfer is started when the coroutine suspends, and the
+//                      coroutine is resumed when it completes, either directly from the I2C ISR
+//                      (I2C_RESUME_ISR) or from dispatchAwaits() called by the application scheduler
+//                      (I2C_RESUME_DEFERRED).  co_await returns the final status.
+//
+enum i2c_resume {I2C_RESUME_ISR, I2C_RESUME_DEFERRED};
+struct i2cAwait
+{
+    struct i2cHandle h;                      // Transfer handle                   (Internal)
+    struct i2cStruct* i2c;                   // Bus data                          (Internal)
+    uint8_t  bus;                            // Bus number                        (Internal)
+    uint8_t  addr;                           // Target 7bit slave address         (Internal)
+    const uint8_t* txData;                   // Tx data                           (Internal)
+    size_t   txLen;                          // Tx length (0=read only)           (Internal)
+    uint8_t* rxBuf;                          // Rx buffer                         (Internal)
+    size_t   rxLen;                          // Rx length (0=write only)          (Internal)
+    i2c_resume resume;                       // Resume method                     (Internal)
+    std::coroutine_handle<> coro;            // Suspended coroutine               (Internal)
+    volatile uint8_t state;                  // 0=starting, 1=suspended, 2=done   (User&ISR)
+    struct i2cAwait* volatile next;          // Deferred resume list link         (User&ISR)
+
+    inline bool await_ready(void) const { return false; }
+    bool await_suspend(std::coroutine_handle<> c);
+    inline i2c_status await_resume(void) const { return h.status(); }
+};
+#endif
+
+
+// ------------------------------------------------------------------------------------------------------
+// Group item - one bus transfer (message list) of a multi-bus group, refer to sendGroup()/transferGroup()
+//
+struct i2cGroupItem
+{
+    uint8_t  bus;                            // Bus number (0=Wire, 1=Wire1, ...) (User)
+    struct i2cTransaction* msgs;             // Message list (combined transfer)  (User)
+    size_t   n;                              // Number of messages                (User)
+    i2c_status status;                       // Result status (first failed msg) (Result)
+    size_t   good;                           // Messages completed successfully   (Result)
+    uint32_t elapsed;                        // Time from group start to done, us (Result)
+    uint32_t tStart;                         // Start time, micros()              (Internal)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Periodic job - a read, write, or write-then-read (eg. register read) transfer run at a fixed period from
+//                a timer interrupt.  Rx data is double-buffered, so the latest complete sample can be read
+//                at any time.  The job and its buffers are owned by the caller, and must remain valid while
+//                the job is active.
+//
+struct i2cJob
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    const uint8_t* txData;                   // Tx data (eg. register addr)       (User)
+    size_t   txLen;                          // Tx length (0=read only)           (User)
+    uint8_t* rxBuf;                          // Rx double buffer, 2*rxLen bytes   (User)
+    size_t   rxLen;                          // Rx length (0=write only)          (User)
+    uint32_t period;                         // Run period in microseconds        (User)
+    struct i2cTransaction msgs[2];           // Tx/Rx messages                    (ISR)
+    struct i2cStruct* i2c;                   // Bus data                          (User)
+    uint8_t  bus;                            // Bus number                        (User)
+    uint32_t countdown;                      // Ticks until next run              (ISR)
+    volatile uint8_t  front;                 // Rx buffer half holding latest     (ISR)
+    volatile uint32_t seq;                   // Completed run count (0=none yet)  (ISR)
+    volatile uint32_t overruns;              // Runs skipped, previous still busy (ISR)
+    volatile i2c_status status;              // Status of last completed run      (ISR)
+    struct i2cJob* volatile next;            // Job list link                     (User&ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Stream - continuous read, or write-then-read (eg. FIFO register read), alternating between two user buffers.
+//          Each read is re-armed from the ISR when the previous one completes, so DMA fills one buffer while
+//          the application processes the other.  The stream and its buffers are owned by the caller, and must
+//          remain valid while the stream is active.
+//
+struct i2cStream
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    const uint8_t* txData;                   // Tx data (eg. FIFO register addr)  (User)
+    size_t   txLen;                          // Tx length (0=read only)           (User)
+    uint8_t* buf[2];                         // Rx buffers, len bytes each        (User)
+    size_t   len;                            // Rx length per read                (User)
+    i2c_done_cb onFill;                      // Buffer filled callback (optional) (User)
+    void*    ctx;                            // Buffer filled callback context    (User)
+    struct i2cTransaction msgs[2];           // Tx/Rx messages                    (ISR)
+    struct i2cStruct* i2c;                   // Bus data                          (User)
+    uint8_t  bus;                            // Bus number                        (User)
+    volatile uint8_t  active;                // Stream running                    (User&ISR)
+    volatile uint8_t  fill;                  // Buffer being filled (next to fill)(ISR)
+    volatile uint8_t  full;                  // Filled buffer mask (bit per buf)  (User&ISR)
+    volatile uint8_t  paused;                // Stalled, no free buffer           (User&ISR)
+    volatile uint32_t seq;                   // Filled buffer count               (ISR)
+    volatile uint32_t stalls;                // Times stalled waiting for release (ISR)
+    volatile i2c_status status;              // Status of last read               (ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Bulk transfer - Master write or read of any length as one START/STOP transaction.  Write data is pulled in
+//                 pieces through the refill callback, and read data is received into a chunk buffer and
+//                 handed to the drain callback each time it fills.  The descriptor and its chunk buffer are
+//                 owned by the caller, and must remain valid until the transfer is done.
+//
+struct i2cBulk
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    i2c_rw   rw;                             // Direction, I2C_WRITE or I2C_READ  (User)
+    size_t   len;                            // Total transfer length             (User)
+    i2c_refill_cb refill;                    // Write refill callback             (User)
+    i2c_drain_cb drain;                      // Read drain callback               (User)
+    uint8_t* buf;                            // Read chunk buffer                 (User)
+    size_t   chunk;                          // Read chunk buffer length          (User)
+    void*    ctx;                            // Refill/drain callback context     (User)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Rx message - one message received in Slave mode, held in a Slave Rx queue until released.
+//
+struct i2cSlaveMsg
+{
+    uint8_t  rxAddr;                         // Target addr of message            (ISR)
+    size_t   len;                            // Message length (limited to size)  (ISR)
+    uint32_t time;                           // Receive done time, micros()       (ISR)
+    uint8_t* data;                           // Message data, in queue buf        (ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Slave Rx queue - ring of received Slave messages, filled by the ISR and drained by the application at its
+//                  own pace (single producer/single consumer, so no locking is needed).  The queue, its slots,
+//                  and its data buffer are owned by the caller, and must remain valid while the queue is set.
+//
+struct i2cSlaveQueue
+{
+    struct i2cSlaveMsg* msgs;                // Message slots, depth entries      (User)
+    uint8_t* buf;                            // Message data, depth * size bytes  (User)
+    size_t   depth;                          // Number of message slots           (User)
+    size_t   size;                           // Max message length                (User)
+    volatile uint32_t head;                  // Messages received                 (ISR)
+    volatile uint32_t tail;                  // Messages released                 (User)
+    volatile uint32_t drops;                 // Messages dropped, queue full      (ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Write coalescing slot - holds pending register writes to one target as a single burst (register address
+//                         followed by data), and the descriptor used to send it.
+//
+struct i2cCoalesce
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    uint8_t  len;                            // Pending data bytes (0=empty)      (User)
+    uint8_t  buf[I2C_COALESCE_LENGTH+1];     // Start register + data             (User)
+    struct i2cTransaction txn;               // Flush transaction                 (User&ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Retry policy - per-address automatic retry of failed Master transfers (refer to setRetryPolicy())
+//
+struct i2cRetryPolicy
+{
+    uint8_t  addr;                           // Target 7bit slave address         (User)
+    uint8_t  attempts;                       // Max attempts incl first (0=unused)(User)
+    uint8_t  retryOn;                        // Retryable status mask             (User)
+    i2c_backoff backoff;                     // Backoff type                      (User)
+    uint32_t delay;                          // Backoff (first retry) in usec     (User)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Bus buffers - Tx/Rx buffer storage sized at compile time, one per bus, so each bus only reserves what it
+//               uses.  The bus data structure refers to it by pointer and length.
+//
+template <size_t TX, size_t RX>
+struct i2cBuffers
+{
+    uint8_t tx[TX];                          // Tx Buffer storage                 (User)
+    uint8_t rx[RX];                          // Rx Buffer storage                 (ISR)
+};
+
+
+// ------------------------------------------------------------------------------------------------------
+// Main I2C data structure - registers, buffers and pins are set per bus by static init (I2C_STRUCT), other
+//                           fields have default initializers
 //
 struct i2cStruct
 {
@@ -377,35 +777,72 @@ struct i2cStruct
     volatile uint8_t* A2;                    // Address Register 2                (User&ISR)
     volatile uint8_t* SLTH;                  // SCL Low Timeout Register High     (User&ISR)
     volatile uint8_t* SLTL;                  // SCL Low Timeout Register Low      (User&ISR)
-    uint8_t  rxBuffer[I2C_RX_BUFFER_LENGTH]; // Rx Buffer                         (ISR)
-    volatile size_t   rxBufferIndex;         // Rx Index                          (User&ISR)
-    volatile size_t   rxBufferLength;        // Rx Length                         (ISR)
-    uint8_t  txBuffer[I2C_TX_BUFFER_LENGTH]; // Tx Buffer                         (User)
-    volatile size_t   txBufferIndex;         // Tx Index                          (User&ISR)
-    volatile size_t   txBufferLength;        // Tx Length                         (User&ISR)
-    i2c_op_mode opMode;                      // Operating Mode                    (User)
-    i2c_mode currentMode;                    // Current Mode                      (User)
+    uint8_t* rxBuffer;                       // Rx Buffer                         (ISR)
+    size_t   rxBufferSize;                   // Rx Buffer size                    (User&ISR)
+    uint8_t* txBuffer;                       // Tx Buffer                         (User)
+    size_t   txBufferSize;                   // Tx Buffer size                    (User)
     volatile uint8_t  currentSCL;            // Current SCL pin                   (User&ISR)
     volatile uint8_t  currentSDA;            // Current SDA pin                   (User&ISR)
-    i2c_pullup currentPullup;                // Current Pullup                    (User)
-    uint32_t currentRate;                    // Current Rate                      (User)
-    i2c_stop currentStop;                    // Current Stop                      (User)
-    volatile i2c_status currentStatus;       // Current Status                    (User&ISR)
-    uint8_t  rxAddr;                         // Rx Address                        (ISR)
-    size_t   reqCount;                       // Byte Request Count                (User)
-    uint8_t  irqCount;                       // IRQ Count, used by SDA-rising ISR (ISR)
-    uint8_t  timeoutRxNAK;                   // Rx Timeout NAK flag               (ISR)
-    volatile i2c_dma_state activeDMA;        // Active DMA flag                   (User&ISR)
-    void (*user_onTransmitDone)(void);       // Master Tx Callback Function       (User)
-    void (*user_onReqFromDone)(void);        // Master Rx Callback Function       (User)
-    void (*user_onReceive)(size_t len);      // Slave Rx Callback Function        (User)
-    void (*user_onRequest)(void);            // Slave Tx Callback Function        (User)
-    void (*user_onError)(void);              // Error Callback Function           (User)
-    DMAChannel* DMA;                         // DMA Channel object                (User&ISR)
-    uint32_t defTimeout;                     // Default Timeout                   (User)
-    volatile uint32_t errCounts[7];          // Error Counts Array                (User&ISR)
-    uint8_t  configuredSCL;                  // SCL configured flag               (User)
-    uint8_t  configuredSDA;                  // SDA configured flag               (User)
+    volatile size_t   rxBufferIndex = 0;     // Rx Index                          (User&ISR)
+    volatile size_t   rxBufferLength = 0;    // Rx Length                         (ISR)
+    volatile size_t   txBufferIndex = 0;     // Tx Index                          (User&ISR)
+    volatile size_t   txBufferLength = 0;    // Tx Length                         (User&ISR)
+    i2c_op_mode opMode = I2C_OP_MODE_ISR;    // Operating Mode                    (User)
+    i2c_mode currentMode = I2C_MASTER;       // Current Mode                      (User)
+    i2c_pullup currentPullup = I2C_PULLUP_EXT; // Current Pullup                    (User)
+    uint32_t currentRate = 100000;           // Current Rate                      (User)
+    i2c_stop currentStop = I2C_STOP;         // Current Stop                      (User)
+    volatile i2c_status currentStatus = I2C_WAITING; // Current Status                    (User&ISR)
+    uint8_t  rxAddr = 0;                     // Rx Address                        (ISR)
+    size_t   reqCount = 0;                   // Byte Request Count                (User)
+    uint8_t  irqCount = 0;                   // IRQ Count, used by SDA-rising ISR (ISR)
+    uint8_t  timeoutRxNAK = 0;               // Rx Timeout NAK flag               (ISR)
+    volatile i2c_dma_state activeDMA = I2C_DMA_OFF; // Active DMA flag                   (User&ISR)
+    void (*user_onTransmitDone)(void) = nullptr; // Master Tx Callback Function       (User)
+    void (*user_onReqFromDone)(void) = nullptr; // Master Rx Callback Function       (User)
+    void (*user_onReceive)(size_t len) = nullptr; // Slave Rx Callback Function        (User)
+    void (*user_onRequest)(void) = nullptr;  // Slave Tx Callback Function        (User)
+    void (*user_onError)(void) = nullptr;    // Error Callback Function           (User)
+    DMAChannel* DMA = nullptr;               // Borrowed DMA Channel, or nullptr  (User&ISR)
+    uint32_t defTimeout = 0;                 // Default Timeout                   (User)
+    volatile uint32_t errCounts[8] = {};     // Error Counts Array                (User&ISR)
+    uint8_t  configuredSCL = 0;              // SCL configured flag               (User)
+    uint8_t  configuredSDA = 0;              // SDA configured flag               (User)
+    const struct i2cSegment* txSeg = nullptr; // Master Tx current segment         (User&ISR)
+    volatile size_t   txSegIndex = 0;        // Master Tx index in segment        (User&ISR)
+    struct i2cSegment txSegBuf = {};         // Master Tx single segment storage  (User&ISR)
+    volatile size_t   txLength = 0;          // Master Tx length (Addr+payload)   (User&ISR)
+    volatile size_t   txDmaLeft = 0;         // Master Tx bytes left for DMA      (ISR)
+    uint8_t* rxPtr = nullptr;                // Master Rx destination             (User&ISR)
+    volatile size_t   rxCount = 0;           // Master Rx count                   (ISR)
+    struct i2cTransaction* volatile txn = nullptr; // Active queued transaction         (User&ISR)
+    struct i2cTransaction* volatile qHead = nullptr; // Transaction queue head            (User&ISR)
+    struct i2cTransaction* volatile qTail = nullptr; // Transaction queue tail            (User&ISR)
+    volatile i2c_done_cb doneCb = nullptr;   // Background Tx/Rx done callback    (User&ISR)
+    void*    doneCtx = nullptr;              // Background Tx/Rx done context     (User&ISR)
+    struct i2cCoalesce coalesce[I2C_COALESCE_SLOTS] = {}; // Pending coalesced writes  (User&ISR)
+    struct i2cRetryPolicy retry[I2C_RETRY_POLICIES] = {}; // Retry policies            (User&ISR)
+    uint8_t  curAddr = 0;                    // Master current target addr        (User&ISR)
+    uint8_t  repStart = 0;                   // Master current began w/ RepSTART  (User&ISR)
+    const struct i2cSegment* txSegFirst = nullptr; // Master Tx first segment           (User&ISR)
+    volatile uint8_t  retryCount = 0;        // Retries of current transfer       (User&ISR)
+    volatile uint8_t  retryWait = 0;         // Retry pending (backoff) flag      (User&ISR)
+    volatile uint32_t retryAt = 0;           // Retry due time (micros)           (ISR)
+    i2c_wait waitMode = I2C_WAIT_SPIN;       // Blocking wait strategy            (User)
+    void (*waitFn)(void) = nullptr;          // User wait function                (User)
+    i2c_acquire acquireMode = I2C_ACQUIRE_POLL; // Busy bus acquisition mode         (User)
+    volatile uint8_t  acqWait = 0;           // Deferred START pending flag       (User&ISR)
+    uint8_t  busFreeTime = 4;                // Bus free time after STOP, usec    (User)
+    uint8_t  stopSettle = 1;                 // Rx settle before STOP, usec        (User&ISR)
+    uint16_t stopWait = 21;                  // Max wait for STOP bus release, usec(User)
+    uint16_t dmaThreshold = I2C_DMA_THRESHOLD; // Min Tx/Rx length using DMA        (User&ISR)
+    uint8_t dmaChain = 0;                    // Chained DMA frames enabled        (User&ISR)
+    DMASetting* chainTCD = nullptr;          // Chained DMA descriptors           (User&ISR)
+    uint8_t chainC1 = 0;                     // Chained DMA end of frame C1 value (ISR)
+    struct i2cBulk* bulk = nullptr;          // Master bulk transfer, or nullptr  (User&ISR)
+    volatile size_t   rxBase = 0;            // Master Rx count at chunk start    (ISR)
+    volatile size_t   rxDmaLen = 0;          // Master Rx DMA chunk length        (ISR)
+    struct i2cSlaveQueue* volatile slaveQueue = nullptr; // Slave Rx message queue, or nullptr (User&ISR)
 };
 
 
@@ -436,6 +873,50 @@ private:
     //
     friend void i2c_isr_handler(struct i2cStruct* i2c, uint8_t bus);
     //
+    // Transfer state machine - run by base handler
+    //
+    static void isrTransfer_(struct i2cStruct* i2c, uint8_t bus);
+    //
+    // Tx segment walker - returns next Master Tx payload byte, and arms DMA with next contiguous chunk.  A bulk
+    //                    write underrun aborts the transfer (status is no longer I2C_SENDING, byte is not sent).
+    //
+    static inline uint8_t txNext_(struct i2cStruct* i2c)
+    {
+        while(i2c->txSegIndex >= i2c->txSeg->len) // skip finished segments, or refill bulk write
+        {
+            if(i2c->bulk == nullptr) i2c->txSeg++; else if(!txRefill_(i2c)) return 0; // underrun, aborted
+            i2c->txSegIndex = 0;
+        }
+        return i2c->txSeg->data[i2c->txSegIndex++];
+    }
+    static void txDmaChunk_(struct i2cStruct* i2c);
+    static uint8_t txRefill_(struct i2cStruct* i2c);
+    //
+    // Rx store - stores next Master Rx byte, and for a bulk read drains the chunk buffer when full or on the
+    //            last byte
+    //
+    static inline void rxStore_(struct i2cStruct* i2c, uint8_t data, uint8_t last)
+    {
+        if(i2c->bulk == nullptr) { i2c->rxPtr[i2c->rxCount++] = data; return; }
+        if(i2c->rxCount - i2c->rxBase >= i2c->bulk->chunk) rxDrain_(i2c);
+        i2c->rxPtr[i2c->rxCount++ - i2c->rxBase] = data;
+        if(last || i2c->rxCount - i2c->rxBase >= i2c->bulk->chunk) rxDrain_(i2c);
+    }
+    static void rxDrain_(struct i2cStruct* i2c);
+    //
+    // Chained DMA frame - loads linked descriptors for the rest of the Tx frame, and handles frame completion
+    //
+    static uint8_t chainLoad_(struct i2cStruct* i2c);
+    static void chainDone_(struct i2cStruct* i2c, uint8_t status);
+    //
+    // Slave Rx DMA - stops DMA mode Slave Rx and sets received length
+    //
+    static void slaveRxDmaStop_(struct i2cStruct* i2c);
+    //
+    // Slave Rx done - adds a completed Slave Rx message to the Slave Rx queue (if set)
+    //
+    static void slaveRxDone_(struct i2cStruct* i2c);
+    //
     // Bus ISRs
     //
     friend void i2c0_isr(void);                 // I2C0 ISR
@@ -471,6 +952,27 @@ public:
     //                       incremented/decremented, not set.
     //
     static volatile uint8_t isrActive;
+    //
+    // Periodic jobs - active job list (all buses), and timer which runs them
+    //
+    static struct i2cJob* volatile jobList;
+    static uint32_t jobTickPeriod;
+    static IntervalTimer jobTimer;
+    //
+    // Retry timer - restarts transfers once their retry backoff expires (all buses), runs while any are pending
+    //
+    static volatile uint8_t retryTimerOn;
+    static IntervalTimer retryTimer;
+    //
+    // DMA channel pool - channels shared by all buses in DMA mode, borrowed per transfer (constructed in
+    //                    static storage, nullptr=not constructed)
+    //
+    static DMAChannel* dmaPool[I2C_DMA_POOL];
+    static uint8_t dmaPoolInit_(void);
+    static void dmaPoolFree_(void);
+    static uint8_t dmaBorrow_(struct i2cStruct* i2c);
+    static void dmaReturn_(struct i2cStruct* i2c);
+    static void dmaAbort_(struct i2cStruct* i2c, uint8_t bus);
 
     // ------------------------------------------------------------------------------------------------------
     // Constructor
@@ -584,13 +1086,68 @@ public:
     // Set Operating Mode - this configures operating mode of the I2C as either Immediate, ISR, or DMA.
     //                      By default Arduino-style begin() calls will initialize to ISR mode.  This can
     //                      only be called when the bus is idle (no changing mode in the middle of Tx/Rx).
-    //                      Note that Slave mode can only use ISR operation.
+    //                      Note that Slave mode can only use ISR operation, except on LC/3.5/3.6 where DMA
+    //                      can be used for Slave Rx (the ISR only handles address match and STOP, Slave Tx
+    //                      stays on ISR as each Master ACK/NAK must be checked).
     // return: 1=success, 0=fail (bus busy)
     // parameters:
     //      opMode = I2C_OP_MODE_ISR, I2C_OP_MODE_DMA, I2C_OP_MODE_IMM
     //
     inline uint8_t setOpMode(i2c_op_mode opMode) { return setOpMode_(i2c, bus, opMode); }
 
+    // ------------------------------------------------------------------------------------------------------
+    // Set DMA Threshold - sets the minimum transfer length which uses DMA in DMA mode, shorter transfers use
+    //                     the ISR method.  Tx length includes the address byte.  The break-even point depends
+    //                     on F_CPU, F_BUS and I2C rate, refer to calibrateDMA() to determine it automatically.
+    // return: none
+    // parameters:
+    //      len = min DMA transfer length (default I2C_DMA_THRESHOLD, limited to 5 minimum)
+    //
+    inline void setDMAThreshold(uint16_t len) { i2c->dmaThreshold = (len < 5) ? 5 : len; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Get DMA Threshold - returns the minimum transfer length which uses DMA in DMA mode
+    // return: min DMA transfer length
+    //
+    inline uint16_t getDMAThreshold(void) { return i2c->dmaThreshold; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Calibrate DMA (base routine)
+    //
+    static uint16_t calibrateDMA_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint16_t maxLen);
+    //
+    // Calibrate DMA - determines the DMA threshold at the current rate and clock settings.  Reads of increasing
+    //                 length are done from the target using both ISR and DMA methods, and the CPU time left free
+    //                 while each runs is measured.  The threshold is set to the shortest length where DMA
+    //                 leaves at least as much CPU time free as ISR (or maxLen+1 if none).  Must be called in
+    //                 DMA mode, as Master, with the bus idle.  Rerun after changing rate.  Rx buffer contents are
+    //                 overwritten, so use a target where reads have no side effects (eg. a register bank).
+    // return: new DMA threshold, 0=fail (not DMA Master mode, or read error - threshold unchanged)
+    // parameters:
+    //      addr = target 7bit slave address
+    //     ^maxLen = max read length to try (default 32, limited to Rx buffer length)
+    //
+    inline uint16_t calibrateDMA(uint8_t addr, uint16_t maxLen=32) { return calibrateDMA_(i2c, bus, addr, maxLen); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Set DMA Chain (base routine)
+    //
+    static uint8_t setDMAChain_(struct i2cStruct* i2c, uint8_t bus, uint8_t enable);
+    //
+    // Set DMA Chain - enables chained DMA frames for DMA mode Master Tx (3.5/3.6 only).  After the address byte
+    //                 is ACKed, the rest of the frame (payload segments and the final STOP or hold of the bus) is
+    //                 done by linked DMA descriptors, so each frame takes two interrupts (address and frame done)
+    //                 instead of one per DMA chunk plus two for the last byte.  The I2C interrupt is off during
+    //                 the payload, so a Slave NAK during the payload is only detected at the end of the frame
+    //                 (as I2C_DATA_NAK, the remaining bytes are still clocked out).  Intended for single-master
+    //                 buses: arbitration lost during the payload is only detected by a finish() timeout.  Rx and
+    //                 transmits with more than I2C_DMA_CHAIN_TCDS-1 segments use normal DMA.
+    // return: 1=success, 0=fail (not 3.5/3.6, not DMA mode, or bus busy)
+    // parameters:
+    //     ^enable = 1=enable (default), 0=disable
+    //
+    inline uint8_t setDMAChain(uint8_t enable=1) { return setDMAChain_(i2c, bus, enable); }
+
     // ------------------------------------------------------------------------------------------------------
     // Set I2C rate (base routine)
     //
@@ -719,13 +1276,34 @@ public:
     // ------------------------------------------------------------------------------------------------------
     // Acquire Bus - acquires bus in Master mode and escalates priority as needed, intended
     //               for internal use only
-    // return: 1=success, 0=fail (cannot acquire bus)
+    // return: 1=success, 2=deferred (bus busy, refer to deferStart_()), 0=fail (cannot acquire bus)
     // parameters:
     //      timeout = timeout in microseconds
     //      forceImm = flag to indicate if immediate mode is required
     //
     static uint8_t acquireBus_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout, uint8_t& forceImm);
 
+    // ------------------------------------------------------------------------------------------------------
+    // Check Priority - escalates I2C IRQ priority above calling routine as needed, intended for
+    //                  internal use only
+    // return: none
+    // parameters:
+    //      forceImm = flag set if current priority cannot be surpassed (immediate mode required)
+    //
+    static void checkPriority_(struct i2cStruct* i2c, uint8_t bus, uint8_t& forceImm);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Start Tx/Rx - starts ISR/DMA Master transfer on an acquired bus using the loaded Tx segments or Rx
+    //               pointer, intended for internal use only
+    // return: none
+    // parameters:
+    //      addrByte = target address byte (Tx)
+    //      addr = target 7bit slave address (Rx)
+    //      i2c_stop = I2C_NOSTOP, I2C_STOP
+    //
+    static void startTx_(struct i2cStruct* i2c, uint8_t addrByte, i2c_stop sendStop);
+    static void startRx_(struct i2cStruct* i2c, uint8_t addr, i2c_stop sendStop);
+
     // ------------------------------------------------------------------------------------------------------
     // Reset Bus - toggles SCL until SDA line is released (9 clocks max).  This is used to correct
     //             a hung bus in which a Slave device missed some clocks and remains stuck outputting
@@ -763,7 +1341,8 @@ public:
     // ------------------------------------------------------------------------------------------------------
     // Send Master Transmit (base routine)
     //
-    static void sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop sendStop, uint32_t timeout);
+    static void sendTransmission_(struct i2cStruct* i2c, uint8_t bus, i2c_stop sendStop, uint32_t timeout,
+                                  i2c_done_cb onDone=nullptr, void* ctx=nullptr);
     //
     // Send Master Transmit - non-blocking routine, starts transmit of Tx buffer to slave. i2c_stop parameter can be
     //                        used to indicate if command should end with a STOP (I2C_STOP) or not (I2C_NOSTOP). Use
@@ -775,6 +1354,49 @@ public:
     //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
     //
     inline void sendTransmission(i2c_stop sendStop=I2C_STOP) { sendTransmission_(i2c, bus, sendStop, 0); }
+    //
+    // Send Master Transmit w/Callback - as above, with a done callback for this transfer.  The callback is run
+    //                                   once when the transfer completes (with or without errors), after the
+    //                                   onTransmitDone()/onError() callbacks, and is given ctx and final status.
+    // return: none
+    // parameters:
+    //      i2c_stop = I2C_NOSTOP, I2C_STOP
+    //      onDone = function of the form void function(void* ctx, i2c_status status)
+    //      ctx = user context pointer passed to onDone
+    //
+    inline void sendTransmission(i2c_stop sendStop, i2c_done_cb onDone, void* ctx)
+        { sendTransmission_(i2c, bus, sendStop, 0, onDone, ctx); callDone_(i2c); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Send Master Transmit Segments (base routine)
+    //
+    static void sendTransmission_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const i2cSegment* segs, size_t n,
+                                  i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone=nullptr, void* ctx=nullptr);
+    //
+    // Send Master Transmit Segments - non-blocking routine, starts scatter-gather transmit to slave at address.
+    //                                 Data is sent directly from a list of caller buffers (eg. a register
+    //                                 header and a payload), in order, without copying through the Tx buffer,
+    //                                 so it is not limited by I2C_TX_BUFFER_LENGTH.  The segment list and its
+    //                                 data must remain valid until the transmit is done.  Use done(),
+    //                                 finish(), or onTransmitDone() callback to determine completion and
+    //                                 status() to determine success/fail.
+    // return: none
+    // parameters:
+    //      addr = target 7bit slave address
+    //      segs = array of Tx segments (data pointer and length)
+    //      n = number of segments
+    //      ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //      ^onDone = done callback for this transfer, void function(void* ctx, i2c_status status) (default none)
+    //      ^ctx = user context pointer passed to onDone (default nullptr)
+    //
+    inline void sendTransmission(uint8_t addr, const i2cSegment* segs, size_t n, i2c_stop sendStop=I2C_STOP,
+                                 i2c_done_cb onDone=nullptr, void* ctx=nullptr)
+        { sendTransmission_(i2c, bus, addr, segs, n, sendStop, 0, onDone, ctx); callDone_(i2c); }
+    //
+    // Send Tx - transmit of segments, Tx buffer (segs = nullptr) or bulk write, intended for internal use only
+    //
+    static void sendTx_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const i2cSegment* segs, size_t n,
+                        struct i2cBulk* bulk, i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone, void* ctx);
 
     // ------------------------------------------------------------------------------------------------------
     // Master Receive (base routine)
@@ -798,10 +1420,30 @@ public:
     inline uint8_t requestFrom(uint8_t addr, uint8_t len, uint8_t sendStop=1)
         { return (uint8_t)requestFrom_(i2c, bus, addr, (size_t)len, (i2c_stop)sendStop, 0); } // Wire compatibility
 
+    // ------------------------------------------------------------------------------------------------------
+    // Master Receive Direct (base routine)
+    //
+    static size_t requestFrom_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop, uint32_t timeout);
+    //
+    // Master Receive Direct - Requests length bytes from slave at address. Receive data is placed directly in
+    //                         the caller buffer (Rx buffer is not used, and length is not limited by
+    //                         I2C_RX_BUFFER_LENGTH).  Timeout parameter can be optionally specified.
+    // return: #bytes received = success, 0=fail (0 length request, NAK, timeout, or bus error)
+    // parameters:
+    //      address = target 7bit slave address
+    //      buf = destination buffer, length bytes
+    //      length = number of bytes requested
+    //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //     ^timeout = timeout in microseconds (default 0 = infinite wait)
+    //
+    inline size_t requestFrom(uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop=I2C_STOP, uint32_t timeout=0)
+        { return requestFrom_(i2c, bus, addr, buf, len, sendStop, timeout); }
+
     // ------------------------------------------------------------------------------------------------------
     // Start Master Receive (base routine)
     //
-    static void sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout);
+    static void sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, size_t len, i2c_stop sendStop, uint32_t timeout,
+                             i2c_done_cb onDone=nullptr, void* ctx=nullptr);
     //
     // Start Master Receive - non-blocking routine, starts request for length bytes from slave at address. Receive
     //                        data will be placed in the Rx buffer. i2c_stop parameter can be used to indicate if
@@ -815,6 +1457,589 @@ public:
     //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
     //
     inline void sendRequest(uint8_t addr, size_t len, i2c_stop sendStop=I2C_STOP) { sendRequest_(i2c, bus, addr, len, sendStop, 0); }
+    //
+    // Start Master Receive w/Callback - as above, with a done callback for this transfer.  The callback is run
+    //                                   once when the transfer completes (with or without errors), after the
+    //                                   onReqFromDone()/onError() callbacks, and is given ctx and final status.
+    // return: none
+    // parameters:
+    //      address = target 7bit slave address
+    //      length = number of bytes requested
+    //      i2c_stop = I2C_NOSTOP, I2C_STOP
+    //      onDone = function of the form void function(void* ctx, i2c_status status)
+    //      ctx = user context pointer passed to onDone
+    //
+    inline void sendRequest(uint8_t addr, size_t len, i2c_stop sendStop, i2c_done_cb onDone, void* ctx)
+        { sendRequest_(i2c, bus, addr, len, sendStop, 0, onDone, ctx); callDone_(i2c); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Start Master Receive Direct (base routine)
+    //
+    static void sendRequest_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop, uint32_t timeout,
+                             i2c_done_cb onDone=nullptr, void* ctx=nullptr);
+    //
+    // Start Master Receive Direct - non-blocking routine, starts request for length bytes from slave at address.
+    //                               Receive data is placed directly in the caller buffer by the ISR or DMA, so
+    //                               no copy out of the Rx buffer is needed (Rx buffer is not used, and length is
+    //                               not limited by I2C_RX_BUFFER_LENGTH).  The buffer must remain valid until
+    //                               done.  Use done(), finish() or onReqFromDone() callback to determine
+    //                               completion and status() to determine success/fail.
+    // return: none
+    // parameters:
+    //      address = target 7bit slave address
+    //      buf = destination buffer, length bytes
+    //      length = number of bytes requested
+    //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //     ^onDone = done callback for this transfer, void function(void* ctx, i2c_status status) (default none)
+    //     ^ctx = user context pointer passed to onDone (default nullptr)
+    //
+    inline void sendRequest(uint8_t addr, uint8_t* buf, size_t len, i2c_stop sendStop=I2C_STOP,
+                            i2c_done_cb onDone=nullptr, void* ctx=nullptr)
+        { sendRequest_(i2c, bus, addr, buf, len, sendStop, 0, onDone, ctx); callDone_(i2c); }
+    //
+    // Send Rx - receive into caller buffer or bulk read, intended for internal use only
+    //
+    static void sendRx_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t* buf, size_t len, struct i2cBulk* bulk,
+                        i2c_stop sendStop, uint32_t timeout, i2c_done_cb onDone, void* ctx);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Queue Transaction (base routine)
+    //
+    static uint8_t queue_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* txn, i2c_stop sendStop);
+    //
+    // Queue Transaction - non-blocking routine, adds a transaction descriptor to the bus queue (in FIFO order,
+    //                     unless txn.deadline/priority are set, refer to schedule()).  Queued
+    //                     transactions run back-to-back from the ISR, each starting as soon as the previous
+    //                     one completes (STOP detected, or RepSTART if previous ended with I2C_NOSTOP), with
+    //                     no foreground involvement.  Tx data is sent directly from, and Rx data received
+    //                     directly into, the descriptor data buffer.  The descriptor and buffer must remain
+    //                     valid until done(txn) returns 1, at which point txn.status and txn.count hold the
+    //                     result.  Blocking and background Tx/Rx calls wait for the queue to drain before
+    //                     acquiring the bus.  If a transaction queued with I2C_NOSTOP fails, the transactions
+    //                     chained after it (up to and including the next I2C_STOP one) are failed with the
+    //                     same status and a STOP is sent.  Requires Master mode with ISR or DMA operation.
+    // return: 1=queued, 0=fail (Slave or IMM mode, zero length read, or descriptor already queued)
+    // parameters:
+    //      txn = transaction descriptor, caller sets addr, rw, data, len, and optionally onDone, ctx (done
+    //            callback run from ISR when the transaction completes, given ctx and final status)
+    //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //
+    inline uint8_t queue(i2cTransaction& txn, i2c_stop sendStop=I2C_STOP) { return queue_(i2c, bus, &txn, sendStop); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Schedule Transaction - non-blocking routine, queues a transaction with a deadline and priority.  The bus
+    //                        queue is serviced from the ISR earliest-deadline-first: transactions with a deadline
+    //                        run before those without, ties (and transactions without deadline) run highest
+    //                        priority first, and equal transactions run in FIFO order.  An active transaction is
+    //                        never preempted, and RepSTART chains are kept together.  A queued transaction is
+    //                        passed at most I2C_SCHED_MAX_BYPASS times, so transactions without deadline are
+    //                        delayed but not starved.  Transactions which complete after their deadline are
+    //                        counted in I2C_ERRCNT_DEADLINE.
+    // return: 1=queued, 0=fail (Slave or IMM mode, zero length read, or descriptor already queued)
+    // parameters:
+    //      txn = transaction descriptor, caller sets addr, rw, data, len
+    //      deadline = absolute deadline in micros() time
+    //     ^priority = priority, higher runs first (default 0)
+    //     ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //
+    inline uint8_t schedule(i2cTransaction& txn, uint32_t deadline, uint8_t priority=0, i2c_stop sendStop=I2C_STOP)
+        { txn.deadline = deadline; txn.hasDeadline = 1; txn.priority = priority; return queue_(i2c, bus, &txn, sendStop); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Transfer (base routine)
+    //
+    static size_t transfer_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* msgs, size_t n, uint32_t timeout);
+    //
+    // Transfer - blocking routine, runs a list of messages as one combined transaction (similar to Linux
+    //            I2C_RDWR).  Messages are chained with RepSTART and a single STOP is sent after the last
+    //            message, so a register read (write reg addr, read data) is one bus transaction with a single
+    //            bus acquisition.  In ISR/DMA mode the list is queued as one unit and chained from the ISR.
+    //            If a message fails the remaining messages are not sent, and are marked with the same status.
+    //            Timeout parameter can be optionally specified.
+    // return: #messages completed successfully (n = success)
+    // parameters:
+    //      msgs = array of transaction descriptors, caller sets addr, rw, data, len
+    //      n = number of messages
+    //      ^timeout = timeout in microseconds (default 0 = infinite wait)
+    //
+    inline size_t transfer(i2cTransaction* msgs, size_t n, uint32_t timeout=0) { return transfer_(i2c, bus, msgs, n, timeout); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Start Handle Transfer (base routine)
+    //
+    static uint8_t startHandle_(struct i2cStruct* i2c, uint8_t bus, i2cHandle* h, uint8_t addr, const uint8_t* txData,
+                                size_t txLen, uint8_t* rxBuf, size_t rxLen, i2c_done_cb onDone=nullptr, void* ctx=nullptr);
+    //
+    // Send Master Transmit (handle) - non-blocking routine, starts a write of length bytes to slave at address,
+    //                                 tracked by handle (use h.done()/h.wait(), then h.status(), h.count(),
+    //                                 h.doneTime()).  Data is sent directly from the caller buffer.  In ISR/DMA
+    //                                 mode the write is queued (refer to queue()), in IMM mode it runs blocking.
+    // return: 1=started, 0=fail (Slave mode, zero length, or handle busy)
+    // parameters:
+    //      h = transfer handle
+    //      address = target 7bit slave address
+    //      data = pointer to data
+    //      length = number of bytes
+    //
+    inline uint8_t sendTransmission(i2cHandle& h, uint8_t addr, const uint8_t* data, size_t len)
+        { return startHandle_(i2c, bus, &h, addr, data, len, nullptr, 0); }
+    //
+    // Send Master Receive (handle) - non-blocking routine, starts a read of length bytes from slave at address
+    //                                directly into the caller buffer, tracked by handle
+    // return: 1=started, 0=fail (Slave mode, zero length, or handle busy)
+    // parameters:
+    //      h = transfer handle
+    //      address = target 7bit slave address
+    //      buf = destination buffer, length bytes
+    //      length = number of bytes requested
+    //
+    inline uint8_t sendRequest(i2cHandle& h, uint8_t addr, uint8_t* buf, size_t len)
+        { return startHandle_(i2c, bus, &h, addr, nullptr, 0, buf, len); }
+    //
+    // Send Transfer (handle) - non-blocking routine, starts a write-then-read (eg. register read) to slave at
+    //                          address as one combined transaction (RepSTART between write and read), tracked
+    //                          by handle
+    // return: 1=started, 0=fail (Slave mode, zero length, or handle busy)
+    // parameters:
+    //      h = transfer handle
+    //      address = target 7bit slave address
+    //      txData = pointer to Tx data (eg. register address)
+    //      txLen = number of Tx bytes
+    //      rxBuf = destination buffer, rxLen bytes
+    //      rxLen = number of bytes requested
+    //
+    inline uint8_t sendTransfer(i2cHandle& h, uint8_t addr, const uint8_t* txData, size_t txLen, uint8_t* rxBuf, size_t rxLen)
+        { return startHandle_(i2c, bus, &h, addr, txData, txLen, rxBuf, rxLen); }
+
+#if defined(__cpp_impl_coroutine)
+    // ------------------------------------------------------------------------------------------------------
+    // Write Async - C++20 awaitable write of length bytes to slave at address, use as:
+    //                   i2c_status s = co_await Wire.writeAsync(addr, data, len);
+    //               The coroutine is suspended while the write runs (other coroutines can use the CPU), and is
+    //               resumed when it completes.  The data must remain valid until resumed.  In ISR/DMA mode the
+    //               write is queued (refer to queue()), in IMM mode it runs blocking and does not suspend.
+    // return: awaitable, co_await returns final status (I2C_WAITING = success)
+    // parameters:
+    //      address = target 7bit slave address
+    //      data = pointer to data
+    //      length = number of bytes
+    //     ^resume = I2C_RESUME_DEFERRED (resume from dispatchAwaits()), I2C_RESUME_ISR (resume directly from
+    //               I2C ISR, coroutine then runs in interrupt context until it next suspends), default deferred
+    //
+    inline i2cAwait writeAsync(uint8_t addr, const uint8_t* data, size_t len, i2c_resume resume=I2C_RESUME_DEFERRED)
+        { return i2cAwait{i2cHandle(), i2c, bus, addr, data, len, nullptr, 0, resume, nullptr, 0, nullptr}; }
+    //
+    // Read Async - C++20 awaitable read of length bytes from slave at address, directly into the caller buffer
+    //              (refer to writeAsync())
+    // return: awaitable, co_await returns final status (I2C_WAITING = success)
+    // parameters:
+    //      address = target 7bit slave address
+    //      buf = destination buffer, length bytes
+    //      length = number of bytes requested
+    //     ^resume = I2C_RESUME_DEFERRED, I2C_RESUME_ISR (default deferred)
+    //
+    inline i2cAwait readAsync(uint8_t addr, uint8_t* buf, size_t len, i2c_resume resume=I2C_RESUME_DEFERRED)
+        { return i2cAwait{i2cHandle(), i2c, bus, addr, nullptr, 0, buf, len, resume, nullptr, 0, nullptr}; }
+    //
+    // Transfer Async - C++20 awaitable write-then-read (eg. register read) to slave at address, as one
+    //                  combined transaction (refer to writeAsync())
+    // return: awaitable, co_await returns final status (I2C_WAITING = success)
+    // parameters:
+    //      address = target 7bit slave address
+    //      txData = pointer to Tx data (eg. register address)
+    //      txLen = number of Tx bytes
+    //      rxBuf = destination buffer, rxLen bytes
+    //      rxLen = number of bytes requested
+    //     ^resume = I2C_RESUME_DEFERRED, I2C_RESUME_ISR (default deferred)
+    //
+    inline i2cAwait transferAsync(uint8_t addr, const uint8_t* txData, size_t txLen, uint8_t* rxBuf, size_t rxLen,
+                                  i2c_resume resume=I2C_RESUME_DEFERRED)
+        { return i2cAwait{i2cHandle(), i2c, bus, addr, txData, txLen, rxBuf, rxLen, resume, nullptr, 0, nullptr}; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Dispatch Awaits - resumes coroutines whose awaited transfers have completed (I2C_RESUME_DEFERRED), in
+    //                   completion order.  Call from the application scheduler loop (not from an ISR).
+    // return: number of coroutines resumed
+    //
+    static size_t dispatchAwaits(void);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Await internals - done callback of awaited transfers, and deferred resume list, intended for internal use
+    //
+    static void awaitDone_(void* ctx, i2c_status status);
+    static struct i2cAwait* volatile awaitHead;
+    static struct i2cAwait* volatile awaitTail;
+#endif
+
+    // ------------------------------------------------------------------------------------------------------
+    // Abort Chain - terminates a timed out chain of queued transactions (contiguous array), and waits for it
+    //               to be done, intended for internal use only
+    // return: none
+    //
+    static void abortChain_(struct i2cStruct* i2c, struct i2cTransaction* first, struct i2cTransaction* last);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Send Group - non-blocking routine, starts a group of transfers spread over several buses, so that they
+    //              run concurrently (eg. a sensor sweep over Wire..Wire3).  Each item is a message list run as
+    //              one combined transaction on its bus (as in transfer()).  Items on ISR/DMA buses are queued
+    //              first, then items on IMM buses are run blocking.  Several items may target the same bus,
+    //              in which case they run in turn.  Use finishGroup() to wait for the group.
+    // return: none
+    // parameters:
+    //      items = array of group items, caller sets bus, msgs, n
+    //      n = number of items
+    //
+    static void sendGroup(i2cGroupItem* items, size_t n);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Finish Group - blocking routine, waits for all transfers of a group started by sendGroup() (join), and
+    //                sets per-item results (status, good, elapsed).  Items which do not complete within the
+    //                timeout are terminated.
+    // return: #items completed successfully (n = success)
+    // parameters:
+    //      items = array of group items
+    //      n = number of items
+    //     ^timeout = timeout in microseconds (default 0 = infinite wait)
+    //
+    static size_t finishGroup(i2cGroupItem* items, size_t n, uint32_t timeout=0);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Transfer Group - blocking routine, runs a group of transfers concurrently over several buses and waits
+    //                  for the whole group (sendGroup() followed by finishGroup())
+    // return: #items completed successfully (n = success)
+    // parameters:
+    //      items = array of group items, caller sets bus, msgs, n
+    //      n = number of items
+    //     ^timeout = timeout in microseconds (default 0 = infinite wait)
+    //
+    static inline size_t transferGroup(i2cGroupItem* items, size_t n, uint32_t timeout=0)
+        { sendGroup(items, n); return finishGroup(items, n, timeout); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Append Queue - inserts a linked chain of prepared transactions into the queue (in scheduling order) as
+    //                a single unit, and starts it if the bus is idle, intended for internal use only
+    // return: none
+    // parameters:
+    //      first = first transaction in chain
+    //      last = last transaction in chain
+    //
+    static void appendQueue_(struct i2cStruct* i2c, uint8_t bus, struct i2cTransaction* first, struct i2cTransaction* last);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Prepare Chain - prepares an array of transactions as a RepSTART chain (STOP after last), intended for
+    //                 internal use only
+    // return: none
+    //
+    static void prepChain_(struct i2cTransaction* msgs, size_t n);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Write Register (base routine)
+    //
+    static uint8_t writeReg_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, uint8_t reg, uint8_t data);
+    //
+    // Write Register - buffers a single register write to a target (8bit register address, auto-increment
+    //                  device), without sending it.  Writes to contiguous registers of the same target are
+    //                  merged into a single burst (rewriting a pending register replaces its value).  Pending
+    //                  writes to a target are sent before any other Tx/Rx to that target, or when
+    //                  flushWrites() is called.  A write which cannot be merged sends the pending burst for
+    //                  that target first.  If all slots are in use, a pending burst is sent to free a slot
+    //                  (this blocks until it completes, so do not call from a callback or ISR).
+    // return: 1=buffered, 0=fail (Slave mode)
+    // parameters:
+    //      addr = target 7bit slave address
+    //      reg = register address
+    //      data = register value
+    //
+    inline uint8_t writeReg(uint8_t addr, uint8_t reg, uint8_t data) { return writeReg_(i2c, bus, addr, reg, data); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Flush Writes (base routine) - sends pending coalesced writes to a target (addr > 0x7F = all targets),
+    //                               without waiting.  In ISR/DMA mode bursts are queued, using the deadline
+    //                               and priority of ref (if given) so they run ahead of the ref transaction.
+    //                               Intended for internal use only.
+    //
+    static void flushWrites_(struct i2cStruct* i2c, uint8_t bus, uint8_t addr, const struct i2cTransaction* ref=nullptr);
+    //
+    // Flush Writes - blocking routine, sends all pending coalesced writes on this bus and waits for them to
+    //                complete (write barrier)
+    // return: 1=all writes successful, 0=one or more writes failed
+    // parameters:
+    //     ^addr = target 7bit slave address (default all targets)
+    //
+    uint8_t flushWrites(uint8_t addr=0xFF);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Set Wait Strategy - sets how blocking calls on this bus wait for background transfers to complete (eg.
+    //                     finish(), endTransmission()/requestFrom() in ISR/DMA mode, transfer(), queue drain).
+    //                     The strategy is only used from non-interrupt code, waits within an ISR or callback
+    //                     always spin.  Timeouts are checked after each wait step.
+    // return: none
+    // parameters:
+    //      mode = I2C_WAIT_SPIN (busy-wait, default), I2C_WAIT_YIELD (call yield() each step),
+    //             I2C_WAIT_WFI (sleep until next interrupt, the I2C interrupt or SysTick wakes the CPU),
+    //             I2C_WAIT_USER (call waitFn each step, eg. an RTOS delay or thread yield)
+    //     ^waitFn = user wait function for I2C_WAIT_USER (default none)
+    //
+    inline void setWaitStrategy(i2c_wait mode, void (*waitFn)(void)=nullptr) { i2c->waitMode = mode; i2c->waitFn = waitFn; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Set Acquire Mode - sets how background Tx/Rx (ISR/DMA mode) acquire a busy bus (eg. multi-master bus, or
+    //                    previous STOP in progress).  In deferred mode the call returns immediately, and the
+    //                    START is issued from the ISR when the STOP-detect interrupt signals the bus is free
+    //                    (the transfer stays in progress meanwhile, and a finish() timeout cancels it).  Deferred
+    //                    mode requires STOP detect, so on 3.0/3.1/3.2, or if the caller priority cannot be
+    //                    surpassed by the I2C ISR, the bus is polled as normal.
+    // return: none
+    // parameters:
+    //      mode = I2C_ACQUIRE_POLL (poll until free or timeout, default), I2C_ACQUIRE_DEFER (defer START to ISR)
+    //
+    inline void setAcquireMode(i2c_acquire mode) { i2c->acquireMode = mode; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Defer Start - arms STOP detect interrupt to start a loaded background Tx/Rx once the bus is free,
+    //               intended for internal use only
+    // return: none
+    // parameters:
+    //      addr = target 7bit slave address
+    //      i2c_stop = I2C_NOSTOP, I2C_STOP
+    //      state = I2C_SENDING (Tx), I2C_SEND_ADDR (Rx)
+    //
+    static void deferStart_(struct i2cStruct* i2c, uint8_t addr, i2c_stop sendStop, i2c_status state);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Restart - takes the bus and (re)starts the loaded background Tx/Rx from the beginning, using the saved
+    //           target, first segment or Rx destination, STOP setting, and state in currentStatus (I2C_SENDING
+    //           for Tx, otherwise Rx), intended for internal use only
+    // return: none
+    //
+    static void restart_(struct i2cStruct* i2c);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Wait Step - performs one step of a blocking wait using the bus wait strategy, intended for internal use
+    //             only.  If status is given, WFI is skipped once it shows the transfer complete (checked with
+    //             interrupts masked, so its completion interrupt cannot be missed).
+    // return: none
+    // parameters:
+    //      status = status being waited on (nullptr = none)
+    //
+    static void wait_(struct i2cStruct* i2c, const volatile i2c_status* status=nullptr);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Set Retry Policy (base routine)
+    //
+    static uint8_t setRetryPolicy_(struct i2cStruct* i2c, uint8_t addr, uint8_t attempts, uint32_t delay,
+                                   i2c_backoff backoff, uint8_t retryOn);
+    //
+    // Set Retry Policy - sets automatic retry of failed Master transfers to a target.  When a transfer ends in
+    //                    a retryable status, the ISR waits for the backoff time and then restarts it from the
+    //                    start (Tx data is resent from the Tx buffer or segments, Rx data is received again).
+    //                    A retried transfer stays in progress, so done(), finish(), status(), done callbacks,
+    //                    and onError only see the final result (a successful retry looks like a normal
+    //                    completion).  The bus is held while waiting (queued transfers wait behind it).
+    //                    Retries apply to ISR/DMA mode transfers which begin with a START (a transfer following
+    //                    a RepSTART cannot be restarted on its own).  Each failed attempt is still counted by
+    //                    the error counters.
+    // return: 1=success, 0=fail (no free policy slot)
+    // parameters:
+    //      addr = target 7bit slave address
+    //      attempts = max number of attempts including the first (0 or 1 = remove policy)
+    //      delay = backoff time in microseconds before first retry (rounded up to I2C_RETRY_TICK)
+    //     ^backoff = I2C_BACKOFF_FIXED (every retry waits delay), I2C_BACKOFF_EXP (delay doubles on each
+    //                retry), default I2C_BACKOFF_FIXED
+    //     ^retryOn = retryable status mask (OR of I2C_RETRY_ADDR_NAK, I2C_RETRY_DATA_NAK, I2C_RETRY_ARB_LOST,
+    //                I2C_RETRY_DMA_ERR), default I2C_RETRY_ALL
+    //
+    inline uint8_t setRetryPolicy(uint8_t addr, uint8_t attempts, uint32_t delay, i2c_backoff backoff=I2C_BACKOFF_FIXED,
+                                  uint8_t retryOn=I2C_RETRY_ALL)
+        { return setRetryPolicy_(i2c, addr, attempts, delay, backoff, retryOn); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Retry internals - check for retry of failed transfer (from ISR, returns 1 if retry pending), retry timer
+    //                   ISR, and cancel of pending retry or deferred START (returns 1 if cancelled), intended
+    //                   for internal use only
+    //
+    static uint8_t retryCheck_(struct i2cStruct* i2c, i2c_status state);
+    static void retryTick_(void);
+    static uint8_t cancelPending_(struct i2cStruct* i2c);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Add Job (base routine)
+    //
+    static uint8_t addJob_(struct i2cStruct* i2c, uint8_t bus, struct i2cJob* job);
+    //
+    // Add Job - starts a periodic job on this bus.  The job is run from a timer interrupt (IntervalTimer),
+    //           which queues its transfer to the bus ISR, so sampling is independent of loop() timing.  Each
+    //           run is scheduled with a deadline of one period (refer to schedule()).  If the previous run
+    //           is still busy when the job is due, the run is skipped and counted in job.overruns.  Rx data
+    //           is received into the back half of job.rxBuf, and the halves are swapped when a run
+    //           completes without error, so use readJob() to get the latest sample.  Requires Master mode
+    //           with ISR or DMA operation.
+    // return: 1=added, 0=fail (Slave or IMM mode, zero period or length, or job already active)
+    // parameters:
+    //      job = job descriptor, caller sets addr, txData, txLen, rxBuf, rxLen, period
+    //
+    inline uint8_t addJob(i2cJob& job) { return addJob_(i2c, bus, &job); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Remove Job - stops a periodic job.  A run in progress is allowed to complete (this waits for it).
+    // return: none
+    // parameters:
+    //      job = job descriptor
+    //
+    static void removeJob(i2cJob& job);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Read Job - copies latest complete Rx sample of a periodic job (rxLen bytes).  Safe to call at any time,
+    //            the copy is retried if a new sample completes while copying.
+    // return: sample number (job.seq of copied sample), 0=no sample yet
+    // parameters:
+    //      job = job descriptor
+    //      dest = destination buffer, rxLen bytes
+    //
+    static uint32_t readJob(const i2cJob& job, uint8_t* dest);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Job internals - timer ISR, job run, job done callback, and timer update, intended for internal use only
+    //
+    static void jobTick_(void);
+    static void runJob_(struct i2cJob* job);
+    static void jobDone_(void* ctx, i2c_status status);
+    static void jobTimerUpdate_(void);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Start Stream (base routine)
+    //
+    static uint8_t startStream_(struct i2cStruct* i2c, uint8_t bus, struct i2cStream* stream);
+    //
+    // Start Stream - starts a continuous read on this bus, alternating between stream.buf[0] and stream.buf[1].
+    //                When a read completes the ISR immediately queues the next one into the other buffer (in
+    //                DMA mode the Rx DMA targets the user buffer directly, so no copying is needed).  Use
+    //                streamBuffer() to get the oldest filled buffer, and releaseStream() when done with it.  If
+    //                both buffers are filled the stream stalls (counted in stream.stalls) until one is released.
+    //                The optional stream.onFill callback runs from the ISR after each read, with ctx and status.
+    //                A read error stops the stream (stream.status holds the error).  Requires Master mode with
+    //                ISR or DMA operation.
+    // return: 1=started, 0=fail (Slave or IMM mode, zero length or missing buffer, or stream already active)
+    // parameters:
+    //      stream = stream descriptor, caller sets addr, txData, txLen, buf[0], buf[1], len, onFill, ctx
+    //
+    inline uint8_t startStream(i2cStream& stream) { return startStream_(i2c, bus, &stream); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Stop Stream - stops a stream.  A read in progress is allowed to complete (this waits for it).  Filled
+    //               buffers stay readable until released.
+    // return: none
+    // parameters:
+    //      stream = stream descriptor
+    //
+    static void stopStream(i2cStream& stream);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Stream Buffer - returns the oldest filled buffer of a stream (len bytes), which is owned by the caller
+    //                 until releaseStream().
+    // return: pointer to filled buffer, nullptr=none filled yet
+    // parameters:
+    //      stream = stream descriptor
+    //
+    static uint8_t* streamBuffer(const i2cStream& stream);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Release Stream - releases the oldest filled buffer of a stream for refill, and resumes a stalled stream.
+    // return: none
+    // parameters:
+    //      stream = stream descriptor
+    //
+    static void releaseStream(i2cStream& stream);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Stream internals - stream read run and done callback, intended for internal use only
+    //
+    static void runStream_(struct i2cStream* stream);
+    static void streamDone_(void* ctx, i2c_status status);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Send Bulk (base routine)
+    //
+    static void sendBulk_(struct i2cStruct* i2c, uint8_t bus, struct i2cBulk* bulk, i2c_stop sendStop, uint32_t timeout,
+                          i2c_done_cb onDone, void* ctx);
+    //
+    // Send Bulk - non-blocking routine, starts a Master write or read of bulk.len bytes as one transaction, not
+    //             limited by the Tx/Rx buffer lengths.  A write pulls its data through bulk.refill as each piece
+    //             is used up (a refill returning 0 is an underrun, which aborts the transfer with I2C_BUF_OVF
+    //             and sends STOP).  A read receives into bulk.buf, and calls bulk.drain with each full chunk and
+    //             with the final partial chunk.  In ISR/DMA mode the callbacks run from the ISR, and in DMA mode each refill
+    //             or chunk is moved by one DMA transfer, so the callbacks should return promptly (the bus clock
+    //             is stretched meanwhile).  Bulk transfers are not retried, as data already refilled or drained
+    //             cannot be replayed.  A zero length or incomplete descriptor fails with I2C_BUF_OVF.  Use done()
+    //             or finish() to determine completion and status() to determine success/fail.
+    // return: none
+    // parameters:
+    //      bulk = bulk descriptor, caller sets addr, rw, len, ctx, and refill (write) or buf, chunk, drain (read)
+    //      ^i2c_stop = I2C_NOSTOP, I2C_STOP (default STOP)
+    //      ^timeout = timeout in microseconds (only used for Immediate operation, default 0 = default timeout)
+    //      ^onDone = done callback for this transfer (nullptr = none), called with ctx and final status
+    //      ^ctx = done callback context
+    //
+    inline void sendBulk(i2cBulk& bulk, i2c_stop sendStop=I2C_STOP, uint32_t timeout=0, i2c_done_cb onDone=nullptr,
+                         void* ctx=nullptr)
+        { sendBulk_(i2c, bus, &bulk, sendStop, timeout, onDone, ctx); callDone_(i2c); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Schedule Before - returns 1 if transaction a should run before transaction b (earliest deadline first,
+    //                   then highest priority, then FIFO), intended for internal use only
+    //
+    static uint8_t schedBefore_(const struct i2cTransaction* a, const struct i2cTransaction* b);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Start Queue - starts transaction at head of queue, intended for internal use only.  Safe to call
+    //               from ISR (bus acquisition will not block ISR, it will resume on STOP detect).
+    // return: none
+    //
+    static void startQueue_(struct i2cStruct* i2c, uint8_t bus);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Service Queue - retires completed transaction and starts next one, intended for internal use only.
+    //                 Called at the end of every I2C ISR.
+    // return: none
+    //
+    static void serviceQueue_(struct i2cStruct* i2c, uint8_t bus);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Retire Queue - records result of the active transaction and removes it from the queue, intended for
+    //                internal use only
+    // return: none
+    //
+    static void retireQueue_(struct i2cStruct* i2c);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Complete Transaction - sets final status of a transaction and runs its done callback, intended for
+    //                        internal use only
+    // return: none
+    //
+    static void completeTxn_(struct i2cTransaction* txn, i2c_status status);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Call Done - runs and disarms the done callback of a background Tx/Rx once it is complete, intended for
+    //             internal use only
+    // return: none
+    //
+    static void callDone_(struct i2cStruct* i2c);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Clear Queue (base routine)
+    //
+    static void clearQueue_(struct i2cStruct* i2c);
+    //
+    // Clear Queue - removes all pending transactions from the queue (an active transaction will run to
+    //               completion).  Removed transactions are marked I2C_NOT_ACQ.
+    // return: none
+    //
+    inline void clearQueue(void) { clearQueue_(i2c); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Queue Done Check - returns 1 if no transactions are queued or running, 0 otherwise
+    //
+    inline uint8_t queueDone(void) { return (i2c->qHead == nullptr); }
 
     // ------------------------------------------------------------------------------------------------------
     // Get Wire Error - returns "Wire" error code from a failed Tx/Rx command
@@ -838,6 +2063,11 @@ public:
     // return: 1=Tx/Rx complete (with or without errors), 0=still running
     //
     inline uint8_t done(void) { return done_(i2c); }
+    //
+    // Done Check (transaction) - returns complete/not-complete value of a queued transaction
+    // return: 1=transaction complete (with or without errors), 0=queued or running
+    //
+    static inline uint8_t done(const i2cTransaction& txn) { return (txn.status < I2C_SENDING); }
 
     // ------------------------------------------------------------------------------------------------------
     // Return Status (base routine)
@@ -845,6 +2075,7 @@ public:
     static uint8_t finish_(struct i2cStruct* i2c, uint8_t bus, uint32_t timeout);
     //
     // Finish - blocking routine, loops until Tx/Rx is complete.  Timeout parameter can be optionally specified.
+    //          On a DMA mode timeout the DMA is aborted and the bus recovered, so it returns in bounded time.
     // return: 1=success (Tx or Rx completed, no error), 0=fail (NAK, timeout or Arb Lost)
     // parameters:
     //      ^timeout = timeout in microseconds (default 0 = infinite wait)
@@ -959,6 +2190,55 @@ public:
     //
     inline void onReceive(void (*function)(size_t len)) { i2c->user_onReceive = function; }
 
+    // ------------------------------------------------------------------------------------------------------
+    // Set Slave Queue (base routine)
+    //
+    static uint8_t setSlaveQueue_(struct i2cStruct* i2c, struct i2cSlaveQueue* queue);
+    //
+    // Set Slave Queue - sets a Slave Rx message queue on this bus.  Each completed Slave Rx message (at STOP
+    //                   or RepSTART) is copied by the ISR into the next free slot with its rxAddr, length, and
+    //                   receive time, before the onReceive() callback runs.  This keeps back-to-back messages
+    //                   which arrive faster than they are processed.  Messages longer than queue.size are
+    //                   truncated, and messages received while the queue is full are dropped (counted in
+    //                   queue.drops).  Use slaveMessage() to get the oldest message, and slaveRelease() when
+    //                   done with it.
+    // return: 1=set, 0=fail (missing slots or buffer, zero depth or size)
+    // parameters:
+    //      queue = queue descriptor, caller sets msgs, buf, depth, size
+    //
+    inline uint8_t setSlaveQueue(i2cSlaveQueue& queue) { return setSlaveQueue_(i2c, &queue); }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Remove Slave Queue - removes the Slave Rx message queue from this bus.  Queued messages stay readable.
+    // return: none
+    //
+    inline void removeSlaveQueue(void) { i2c->slaveQueue = nullptr; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Slave Available - returns number of messages waiting in a Slave Rx queue
+    // return: message count
+    // parameters:
+    //      queue = queue descriptor
+    //
+    static inline size_t slaveAvailable(const i2cSlaveQueue& queue) { return queue.head - queue.tail; }
+
+    // ------------------------------------------------------------------------------------------------------
+    // Slave Message - returns the oldest message in a Slave Rx queue, which is owned by the caller until
+    //                 slaveRelease().
+    // return: pointer to message, nullptr=queue empty
+    // parameters:
+    //      queue = queue descriptor
+    //
+    static const i2cSlaveMsg* slaveMessage(const i2cSlaveQueue& queue);
+
+    // ------------------------------------------------------------------------------------------------------
+    // Slave Release - releases the oldest message in a Slave Rx queue, freeing its slot for the ISR.
+    // return: none
+    // parameters:
+    //      queue = queue descriptor
+    //
+    static void slaveRelease(i2cSlaveQueue& queue);
+
     // ------------------------------------------------------------------------------------------------------
     // Set callback function for Slave Tx
     //
@@ -974,7 +2254,7 @@ public:
     // return: error count
     // parameters:
     //      counter = I2C_ERRCNT_RESET_BUS, I2C_ERRCNT_TIMEOUT, I2C_ERRCNT_ADDR_NAK, I2C_ERRCNT_DATA_NAK,
-    //                I2C_ERRCNT_ARBL, I2C_ERRCNT_NOT_ACQ, I2C_ERRCNT_DMA_ERR
+    //                I2C_ERRCNT_ARBL, I2C_ERRCNT_NOT_ACQ, I2C_ERRCNT_DMA_ERR, I2C_ERRCNT_DEADLINE
     //
     inline uint32_t getErrorCount(i2c_err_count counter) { return i2c->errCounts[counter]; }
     // ------------------------------------------------------------------------------------------------------
@@ -982,7 +2262,7 @@ public:
     // return: none
     // parameters:
     //      counter = I2C_ERRCNT_RESET_BUS, I2C_ERRCNT_TIMEOUT, I2C_ERRCNT_ADDR_NAK, I2C_ERRCNT_DATA_NAK,
-    //                I2C_ERRCNT_ARBL, I2C_ERRCNT_NOT_ACQ, I2C_ERRCNT_DMA_ERR
+    //                I2C_ERRCNT_ARBL, I2C_ERRCNT_NOT_ACQ, I2C_ERRCNT_DMA_ERR, I2C_ERRCNT_DEADLINE
     //
     inline void zeroErrorCount(i2c_err_count counter) { i2c->errCounts[counter] = 0; }
 